@@ -113,6 +113,9 @@ pub fn main() !void {
     var fuzz = false;
     var debounce_interval_ms: u16 = 50;
     var listen_port: u16 = 0;
+    var prebuild_runtimes = false;
+    var prebuild_targets = ArrayList([]const u8).init(arena);
+    var prebuild_optimize_modes = ArrayList(std.builtin.OptimizeMode).init(arena);
 
     while (nextArg(args, &arg_idx)) |arg| {
         if (mem.startsWith(u8, arg, "-Z")) {
@@ -260,6 +263,19 @@ pub fn main() !void {
                 graph.incremental = true;
             } else if (mem.eql(u8, arg, "-fno-incremental")) {
                 graph.incremental = false;
+            } else if (mem.eql(u8, arg, "--prebuild-runtimes")) {
+                prebuild_runtimes = true;
+            } else if (mem.eql(u8, arg, "--prebuild-runtimes-target")) {
+                prebuild_runtimes = true;
+                try prebuild_targets.append(nextArgOrFatal(args, &arg_idx));
+            } else if (mem.eql(u8, arg, "--prebuild-runtimes-optimize")) {
+                const next_arg = nextArg(args, &arg_idx) orelse
+                    fatalWithHint("expected optimization mode after '{s}'", .{arg});
+                try prebuild_optimize_modes.append(std.meta.stringToEnum(std.builtin.OptimizeMode, next_arg) orelse {
+                    fatalWithHint("expected [Debug|ReleaseSafe|ReleaseFast|ReleaseSmall] after '{s}', found '{s}'", .{
+                        arg, next_arg,
+                    });
+                });
             } else if (mem.eql(u8, arg, "-fwine")) {
                 builder.enable_wine = true;
             } else if (mem.eql(u8, arg, "-fno-wine")) {
@@ -314,6 +330,13 @@ pub fn main() !void {
         }
     }
 
+    const runtime_store: ?[]const u8 = if (prebuild_runtimes) store: {
+        const path = graph.env_map.get("ZIG_RUNTIME_STORE") orelse
+            fatal("--prebuild-runtimes requires the ZIG_RUNTIME_STORE environment variable", .{});
+        break :store try std.fs.path.resolve(arena, &.{path});
+    } else null;
+    if (prebuild_optimize_modes.items.len == 0) try prebuild_optimize_modes.append(.Debug);
+
     const stderr = std.io.getStdErr();
     const ttyconf = get_tty_conf(color, stderr);
     switch (ttyconf) {
@@ -369,6 +392,17 @@ pub fn main() !void {
     if (steps_menu)
         return steps(builder, stdout_writer);
 
+    if (runtime_store) |store| {
+        builder.default_step = try prebuildRuntimesStep(
+            builder,
+            store,
+            targets.items,
+            prebuild_targets.items,
+            prebuild_optimize_modes.items,
+        );
+        targets.clearRetainingCapacity();
+    }
+
     var run: Run = .{
         .max_rss = max_rss,
         .max_rss_is_default = false,
@@ -521,6 +555,96 @@ const Run = struct {
     }
 };
 
+/// Returns a step which, instead of making `step_names`, builds only the runtime
+/// libraries their executables and shared libraries link, plus those of each of
+/// `extra_targets` in each of `extra_optimize_modes`, and adds them to `store`.
+/// Each configuration is built by compiling an empty C program with the same
+/// target, optimization mode and runtime-relevant flags.
+fn prebuildRuntimesStep(
+    b: *std.Build,
+    store: []const u8,
+    step_names: []const []const u8,
+    extra_targets: []const []const u8,
+    extra_optimize_modes: []const std.builtin.OptimizeMode,
+) !*Step {
+    const arena = b.allocator;
+
+    const top = try arena.create(Step);
+    top.* = Step.init(.{
+        .id = .custom,
+        .name = "prebuild runtimes",
+        .owner = b,
+    });
+    const stub = b.addWriteFiles().add("main.c", "int main(void) { return 0; }\n");
+
+    var configs = std.StringArrayHashMap([]const []const u8).init(arena);
+    for (extra_targets) |triple| {
+        for (extra_optimize_modes) |optimize| {
+            const argv = try arena.dupe([]const u8, &.{
+                "-target", triple, "-O", @tagName(optimize), "-lc", "-lc++",
+            });
+            try configs.put(try mem.join(arena, " ", argv), argv);
+        }
+    }
+
+    var seen = std.AutoArrayHashMap(*Step, void).init(arena);
+    if (step_names.len == 0) {
+        try seen.put(b.default_step, {});
+    } else for (step_names) |step_name| {
+        const s = b.top_level_steps.get(step_name) orelse {
+            std.debug.print("no step named '{s}'\n  access the help menu with 'zig build -h'\n", .{step_name});
+            process.exit(1);
+        };
+        try seen.put(&s.step, {});
+    }
+    var i: usize = 0;
+    while (i < seen.count()) : (i += 1) {
+        const s = seen.keys()[i];
+        for (s.dependencies.items) |dep| try seen.put(dep, {});
+
+        const compile = s.cast(Step.Compile) orelse continue;
+        if (compile.kind != .exe and compile.kind != .@"test" and !compile.isDynamicLibrary()) continue;
+        const link_libcpp = compile.dependsOnSystemLibrary("c++");
+        if (!link_libcpp and !compile.dependsOnSystemLibrary("c")) continue;
+
+        const module = &compile.root_module;
+        var argv = ArrayList([]const u8).init(arena);
+        const target = module.resolved_target.?;
+        if (!target.query.isNative()) try argv.appendSlice(&.{
+            "-target", try target.query.zigTriple(arena),
+            "-mcpu",   try target.query.serializeCpuAlloc(arena),
+        });
+        try argv.appendSlice(&.{ "-O", @tagName(module.optimize orelse .Debug), "-lc" });
+        if (link_libcpp) try argv.append("-lc++");
+        if (compile.linkage) |linkage| try argv.append(switch (linkage) {
+            .dynamic => "-dynamic",
+            .static => "-static",
+        });
+        if (module.single_threaded) |x| try argv.append(if (x) "-fsingle-threaded" else "-fno-single-threaded");
+        if (module.pic) |x| try argv.append(if (x) "-fPIC" else "-fno-PIC");
+        if (module.unwind_tables) |x| try argv.append(if (x) "-funwind-tables" else "-fno-unwind-tables");
+        if (module.sanitize_thread) |x| try argv.append(if (x) "-fsanitize-thread" else "-fno-sanitize-thread");
+        try configs.put(try mem.join(arena, " ", argv.items), argv.items);
+    }
+
+    for (configs.keys(), configs.values()) |name, argv| {
+        const run = b.addSystemCommand(&.{ b.graph.zig_exe, "build-exe" });
+        run.setName(b.fmt("prebuild runtimes {s}", .{name}));
+        run.addArgs(argv);
+        run.addArgs(&.{ "--runtime-store", store, "--populate-runtime-store" });
+        run.addArgs(&.{
+            "--cache-dir",        b.cache_root.path orelse ".",
+            "--global-cache-dir", b.graph.global_cache_root.path orelse ".",
+        });
+        run.addFileArg(stub);
+        _ = run.addPrefixedOutputFileArg("-femit-bin=", "stub");
+        // The compiler adds runtime libraries found in its cache to the store too.
+        run.has_side_effects = true;
+        top.dependOn(&run.step);
+    }
+    return top;
+}
+
 fn prepare(
     gpa: Allocator,
     arena: Allocator,
@@ -1284,6 +1408,12 @@ fn usage(b: *std.Build, out_stream: anytype) !void {
         \\  --debounce <ms>              Delay before rebuilding after changed file detected
         \\     -fincremental             Enable incremental compilation
         \\  -fno-incremental             Disable incremental compilation
+        \\  --prebuild-runtimes          Instead of building the given steps, add the runtime
+        \\                               libraries they link to ZIG_RUNTIME_STORE
+        \\  --prebuild-runtimes-target [triple]
+        \\                               Also add the runtime libraries of this target
+        \\  --prebuild-runtimes-optimize [mode]
+        \\                               Optimization mode for --prebuild-runtimes-target (default Debug)
         \\
         \\Project-Specific Options:
         \\
@@ -570,7 +570,7 @@ pub const Compiler = struct {
 
                         try header.write(writer, .{ .diagnostics = self.diagnostics, .token = node.id });
                         try file.seekTo(0);
-                        try writeResourceData(writer, file.reader(), header.data_size);
+                        try writeFileData(writer, file, header.data_size);
                         return;
                     }
 
@@ -787,7 +787,7 @@ pub const Compiler = struct {
                         }
 
                         try file.seekTo(entry.data_offset_from_start_of_file);
-                        try writeResourceDataNoPadding(writer, file.reader(), entry.data_size_in_bytes);
+                        try writeFileDataNoPadding(writer, file, entry.data_size_in_bytes);
                         try writeDataPadding(writer, full_data_size);
 
                         if (self.state.icon_id == std.math.maxInt(u16)) {
@@ -923,7 +923,7 @@ pub const Compiler = struct {
                     }
                     try file.seekTo(bitmap_info.pixel_data_offset);
                     const pixel_bytes: u32 = @intCast(file_size - bitmap_info.pixel_data_offset);
-                    try writeResourceDataNoPadding(writer, file_reader, pixel_bytes);
+                    try writeFileDataNoPadding(writer, file, pixel_bytes);
                     try writeDataPadding(writer, bmp_bytes_to_write);
                     return;
                 },
@@ -999,7 +999,7 @@ pub const Compiler = struct {
         // We now know that the data size will fit in a u32
         header.data_size = @intCast(data_size);
         try header.write(writer, .{ .diagnostics = self.diagnostics, .token = node.id });
-        try writeResourceData(writer, file.reader(), header.data_size);
+        try writeFileData(writer, file, header.data_size);
     }
 
     fn iconReadError(
@@ -1275,6 +1275,46 @@ pub const Compiler = struct {
         try writeDataPadding(writer, data_size);
     }
 
+    /// Files at least this large are memory-mapped by `writeFileDataNoPadding`
+    /// rather than pumped through a small buffer.
+    const mmap_threshold = 64 * 1024;
+    const can_mmap = builtin.os.tag != .windows and builtin.os.tag != .wasi;
+
+    /// Like `writeResourceDataNoPadding`, but reads `data_size` bytes starting at
+    /// the current position of `file`, and leaves the position after them.
+    ///
+    /// Large ranges are memory-mapped and given to `writer` in a single call, so a
+    /// buffered writer can pass them straight through to the output instead of
+    /// copying them 4 KiB at a time. Anything that can't be mapped (including a
+    /// file which is shorter than `data_size`) falls back to reading it.
+    pub fn writeFileDataNoPadding(writer: anytype, file: std.fs.File, data_size: u32) !void {
+        if (can_mmap and data_size >= mmap_threshold) mmap: {
+            const pos = try file.getPos();
+            const end = pos + data_size;
+            if (end > try file.getEndPos()) break :mmap;
+            const mapped_len = std.math.cast(usize, end) orelse break :mmap;
+            const mapped = std.posix.mmap(
+                null,
+                mapped_len,
+                std.posix.PROT.READ,
+                .{ .TYPE = .PRIVATE },
+                file.handle,
+                0,
+            ) catch break :mmap;
+            defer std.posix.munmap(mapped);
+
+            try writer.writeAll(mapped[@intCast(pos)..]);
+            try file.seekTo(end);
+            return;
+        }
+        try writeResourceDataNoPadding(writer, file.reader(), data_size);
+    }
+
+    pub fn writeFileData(writer: anytype, file: std.fs.File, data_size: u32) !void {
+        try writeFileDataNoPadding(writer, file, data_size);
+        try writeDataPadding(writer, data_size);
+    }
+
     pub fn writeDataPadding(writer: anytype, data_size: u32) !void {
         try writer.writeByteNTimes(0, numPaddingBytesNeeded(data_size));
     }
@@ -3003,6 +3043,36 @@ test "limitedWriter basic usage" {
     try std.testing.expectError(error.NoSpaceLeft, writer.write("5"));
 }
 
+test "writeFileDataNoPadding" {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const contents = try std.testing.allocator.alloc(u8, Compiler.mmap_threshold * 2);
+    defer std.testing.allocator.free(contents);
+    for (contents, 0..) |*byte, i| byte.* = @truncate(i *% 7);
+    try tmp.dir.writeFile(.{ .sub_path = "data.bin", .data = contents });
+
+    const file = try tmp.dir.openFile("data.bin", .{});
+    defer file.close();
+
+    var buf = std.ArrayList(u8).init(std.testing.allocator);
+    defer buf.deinit();
+
+    // Small enough to be read, then large enough to be mapped.
+    const offset = 3;
+    const small_size = 100;
+    try file.seekTo(offset);
+    try Compiler.writeFileDataNoPadding(buf.writer(), file, small_size);
+    try Compiler.writeFileDataNoPadding(buf.writer(), file, Compiler.mmap_threshold);
+    try std.testing.expectEqual(offset + small_size + Compiler.mmap_threshold, try file.getPos());
+    try std.testing.expectEqualSlices(u8, contents[offset..][0 .. small_size + Compiler.mmap_threshold], buf.items);
+
+    // Asking for more than the file contains writes what is there.
+    buf.clearRetainingCapacity();
+    try Compiler.writeFileDataNoPadding(buf.writer(), file, Compiler.mmap_threshold);
+    try std.testing.expectEqualSlices(u8, contents[offset + small_size + Compiler.mmap_threshold ..], buf.items);
+}
+
 pub const FontDir = struct {
     fonts: std.ArrayListUnmanaged(Font) = .{},
     /// To keep track of which ids are set and where they were set from
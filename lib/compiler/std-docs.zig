@@ -154,16 +154,16 @@ fn serveDocsFile(
     name: []const u8,
     content_type: []const u8,
 ) !void {
-    const gpa = context.gpa;
-    // The desired API is actually sendfile, which will require enhancing std.http.Server.
-    // We load the file with every request so that the user can make changes to the file
+    // We open the file with every request so that the user can make changes to the file
     // and refresh the HTML page without restarting this server.
-    const file_contents = try context.lib_dir.readFileAlloc(gpa, name, 10 * 1024 * 1024);
-    defer gpa.free(file_contents);
-    try request.respond(file_contents, .{
-        .extra_headers = &.{
-            .{ .name = "content-type", .value = content_type },
-            cache_control_header,
+    const file = try context.lib_dir.openFile(name, .{});
+    defer file.close();
+    try request.respondFile(file, .{
+        .respond_options = .{
+            .extra_headers = &.{
+                .{ .name = "content-type", .value = content_type },
+                cache_control_header,
+            },
         },
     });
 }
@@ -257,13 +257,14 @@ fn serveWasm(
     // Do the compilation every request, so that the user can edit the files
     // and see the changes without restarting the server.
     const wasm_binary_path = try buildWasmBinary(arena, context, optimize_mode);
-    // std.http.Server does not have a sendfile API yet.
-    const file_contents = try std.fs.cwd().readFileAlloc(gpa, wasm_binary_path, 10 * 1024 * 1024);
-    defer gpa.free(file_contents);
-    try request.respond(file_contents, .{
-        .extra_headers = &.{
-            .{ .name = "content-type", .value = "application/wasm" },
-            cache_control_header,
+    const file = try std.fs.cwd().openFile(wasm_binary_path, .{});
+    defer file.close();
+    try request.respondFile(file, .{
+        .respond_options = .{
+            .extra_headers = &.{
+                .{ .name = "content-type", .value = "application/wasm" },
+                cache_control_header,
+            },
         },
     });
 }
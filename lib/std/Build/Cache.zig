@@ -167,6 +167,72 @@ pub const File = struct {
     }
 };
 
+/// Remembers the stat and digest of files across every `Manifest` sharing it,
+/// so that a file listed in many manifests, such as a C header included by
+/// every translation unit, is only opened and hashed once. This assumes the
+/// files do not change while the memo is in use; call `clear` whenever they
+/// might have, for example at the start of each update.
+pub const FileMemo = struct {
+    mutex: std.Thread.Mutex = .{},
+    /// Keys are owned by the memo.
+    map: std.HashMapUnmanaged(PrefixedPath, Entry, Context, std.hash_map.default_max_load_percentage) = .{},
+
+    pub const Entry = struct {
+        stat: File.Stat,
+        bin_digest: BinDigest,
+    };
+
+    const Context = struct {
+        pub fn hash(ctx: Context, pp: PrefixedPath) u64 {
+            _ = ctx;
+            return std.hash.Wyhash.hash(pp.prefix, pp.sub_path);
+        }
+
+        pub fn eql(ctx: Context, a: PrefixedPath, b: PrefixedPath) bool {
+            _ = ctx;
+            return a.eql(b);
+        }
+    };
+
+    pub fn deinit(memo: *FileMemo, gpa: Allocator) void {
+        memo.clear(gpa);
+        memo.map.deinit(gpa);
+        memo.* = undefined;
+    }
+
+    pub fn clear(memo: *FileMemo, gpa: Allocator) void {
+        memo.mutex.lock();
+        defer memo.mutex.unlock();
+
+        var it = memo.map.keyIterator();
+        while (it.next()) |key| gpa.free(key.sub_path);
+        memo.map.clearRetainingCapacity();
+    }
+
+    fn get(memo: *FileMemo, pp: PrefixedPath) ?Entry {
+        memo.mutex.lock();
+        defer memo.mutex.unlock();
+        return memo.map.get(pp);
+    }
+
+    /// The memo is only an optimization, so allocation failure just leaves
+    /// the file out of it.
+    fn put(memo: *FileMemo, gpa: Allocator, pp: PrefixedPath, entry: Entry) void {
+        memo.mutex.lock();
+        defer memo.mutex.unlock();
+
+        const gop = memo.map.getOrPut(gpa, pp) catch return;
+        if (!gop.found_existing) {
+            const sub_path = gpa.dupe(u8, pp.sub_path) catch {
+                memo.map.removeByPtr(gop.key_ptr);
+                return;
+            };
+            gop.key_ptr.* = .{ .prefix = pp.prefix, .sub_path = sub_path };
+        }
+        gop.value_ptr.* = entry;
+    }
+};
+
 pub const HashHelper = struct {
     hasher: Hasher = hasher_init,
 
@@ -311,6 +377,9 @@ pub const Manifest = struct {
     /// Keeps track of the last time we performed a file system write to observe
     /// what time the file system thinks it is, according to its own granularity.
     recent_problematic_timestamp: i128 = 0,
+    /// When set, the states of input files are taken from and recorded to
+    /// this memo instead of always going to the file system.
+    file_memo: ?*FileMemo = null,
 
     pub const Files = std.ArrayHashMapUnmanaged(File, void, FilesContext, false);
 
@@ -562,10 +631,35 @@ pub const Manifest = struct {
                 };
 
                 const pp = cache_hash_file.prefixed_path;
+                if (self.file_memo) |memo| if (memo.get(pp)) |entry| {
+                    if (!std.meta.eql(entry.stat, cache_hash_file.stat)) {
+                        self.manifest_dirty = true;
+                        cache_hash_file.stat = entry.stat;
+                    }
+                    if (!mem.eql(u8, &cache_hash_file.bin_digest, &entry.bin_digest)) {
+                        cache_hash_file.bin_digest = entry.bin_digest;
+                        any_file_changed = true;
+                    }
+                    if (!any_file_changed) {
+                        self.hash.hasher.update(&cache_hash_file.bin_digest);
+                    }
+                    continue;
+                };
+
                 const dir = self.cache.prefixes()[pp.prefix].handle;
                 const this_file = dir.openFile(pp.sub_path, .{ .mode = .read_only }) catch |err| switch (err) {
                     error.FileNotFound => {
                         if (try self.upgradeToExclusiveLock()) continue;
+                        // cache miss; the input files not yet reached still need their digests
+                        self.manifest_dirty = true;
+                        var i = idx + 1;
+                        while (i < input_file_count) : (i += 1) {
+                            const ch_file = &self.files.keys()[i];
+                            self.populateFileHash(ch_file) catch |e| {
+                                self.failed_file_index = i;
+                                return e;
+                            };
+                        }
                         return false;
                     },
                     else => return error.CacheUnavailable,
@@ -608,6 +702,11 @@ pub const Manifest = struct {
                     }
                 }
 
+                if (self.file_memo) |memo| memo.put(gpa, pp, .{
+                    .stat = cache_hash_file.stat,
+                    .bin_digest = cache_hash_file.bin_digest,
+                });
+
                 if (!any_file_changed) {
                     self.hash.hasher.update(&cache_hash_file.bin_digest);
                 }
@@ -694,6 +793,13 @@ pub const Manifest = struct {
 
     fn populateFileHash(self: *Manifest, ch_file: *File) !void {
         const pp = ch_file.prefixed_path;
+        if (ch_file.max_file_size == null) if (self.file_memo) |memo| if (memo.get(pp)) |entry| {
+            ch_file.stat = entry.stat;
+            ch_file.bin_digest = entry.bin_digest;
+            self.hash.hasher.update(&ch_file.bin_digest);
+            return;
+        };
+
         const dir = self.cache.prefixes()[pp.prefix].handle;
         const file = try dir.openFile(pp.sub_path, .{});
         defer file.close();
@@ -737,6 +843,11 @@ pub const Manifest = struct {
             try hashFile(file, &ch_file.bin_digest);
         }
 
+        if (self.file_memo) |memo| memo.put(self.cache.gpa, pp, .{
+            .stat = ch_file.stat,
+            .bin_digest = ch_file.bin_digest,
+        });
+
         self.hash.hasher.update(&ch_file.bin_digest);
     }
 
@@ -1390,3 +1501,60 @@ test "Manifest with files added after initial hash work" {
         try testing.expect(!mem.eql(u8, &digest1, &digest3));
     }
 }
+
+test "FileMemo shares file hashes between manifests" {
+    if (builtin.os.tag == .wasi) {
+        // https://github.com/ziglang/zig/issues/5437
+        return error.SkipZigTest;
+    }
+    var tmp = testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const temp_file = "memo.txt";
+    const temp_manifest_dir = "temp_manifest_dir";
+
+    try tmp.dir.writeFile(.{ .sub_path = temp_file, .data = "Hello, world!\n" });
+
+    var cache = Cache{
+        .gpa = testing.allocator,
+        .manifest_dir = try tmp.dir.makeOpenPath(temp_manifest_dir, .{}),
+    };
+    cache.addPrefix(.{ .path = null, .handle = tmp.dir });
+    defer cache.manifest_dir.close();
+
+    var memo: FileMemo = .{};
+    defer memo.deinit(testing.allocator);
+
+    var digest1: HexDigest = undefined;
+    var digest2: HexDigest = undefined;
+
+    {
+        var ch = cache.obtain();
+        defer ch.deinit();
+        ch.file_memo = &memo;
+
+        ch.hash.addBytes("1");
+        _ = try ch.addFile(temp_file, null);
+        try testing.expectEqual(false, try ch.hit());
+        digest1 = ch.final();
+        try ch.writeManifest();
+    }
+    try testing.expectEqual(1, memo.map.count());
+
+    // The second manifest must not need to look at the file again.
+    try tmp.dir.deleteFile(temp_file);
+    {
+        var ch = cache.obtain();
+        defer ch.deinit();
+        ch.file_memo = &memo;
+
+        ch.hash.addBytes("2");
+        _ = try ch.addFile(temp_file, null);
+        try testing.expectEqual(false, try ch.hit());
+        digest2 = ch.final();
+    }
+    try testing.expect(!mem.eql(u8, &digest1, &digest2));
+
+    memo.clear(testing.allocator);
+    try testing.expectEqual(0, memo.map.count());
+}
@@ -151,19 +151,19 @@ fn serveFile(
     name: []const u8,
     content_type: []const u8,
 ) !void {
-    const gpa = ws.gpa;
-    // The desired API is actually sendfile, which will require enhancing std.http.Server.
-    // We load the file with every request so that the user can make changes to the file
+    // We open the file with every request so that the user can make changes to the file
     // and refresh the HTML page without restarting this server.
-    const file_contents = ws.zig_lib_directory.handle.readFileAlloc(gpa, name, 10 * 1024 * 1024) catch |err| {
-        log.err("failed to read '{}{s}': {s}", .{ ws.zig_lib_directory, name, @errorName(err) });
+    const file = ws.zig_lib_directory.handle.openFile(name, .{}) catch |err| {
+        log.err("failed to open '{}{s}': {s}", .{ ws.zig_lib_directory, name, @errorName(err) });
         return error.AlreadyReported;
     };
-    defer gpa.free(file_contents);
-    try request.respond(file_contents, .{
-        .extra_headers = &.{
-            .{ .name = "content-type", .value = content_type },
-            cache_control_header,
+    defer file.close();
+    try request.respondFile(file, .{
+        .respond_options = .{
+            .extra_headers = &.{
+                .{ .name = "content-type", .value = content_type },
+                cache_control_header,
+            },
         },
     });
 }
@@ -182,13 +182,14 @@ fn serveWasm(
     // Do the compilation every request, so that the user can edit the files
     // and see the changes without restarting the server.
     const wasm_binary_path = try buildWasmBinary(ws, arena, optimize_mode);
-    // std.http.Server does not have a sendfile API yet.
-    const file_contents = try std.fs.cwd().readFileAlloc(gpa, wasm_binary_path, 10 * 1024 * 1024);
-    defer gpa.free(file_contents);
-    try request.respond(file_contents, .{
-        .extra_headers = &.{
-            .{ .name = "content-type", .value = "application/wasm" },
-            cache_control_header,
+    const file = try std.fs.cwd().openFile(wasm_binary_path, .{});
+    defer file.close();
+    try request.respondFile(file, .{
+        .respond_options = .{
+            .extra_headers = &.{
+                .{ .name = "content-type", .value = "application/wasm" },
+                cache_control_header,
+            },
         },
     });
 }
@@ -34,6 +34,19 @@ kind: Kind,
 major_only_filename: ?[]const u8,
 name_only_filename: ?[]const u8,
 formatted_panics: ?bool = null,
+/// Run AIR optimizations, such as redundant safety check removal, before code generation.
+air_optimize: ?bool = null,
+/// Compile C and C++ sources on the compiler's thread pool instead of in
+/// child processes.
+clang_in_process: ?bool = null,
+/// Have `@cImport` skip C function bodies, translating functions defined in
+/// headers as declarations which fail when referenced.
+cimport_skip_function_bodies: ?bool = null,
+/// Produce a thin static library, which references object files in the cache
+/// instead of containing copies of them. Member paths are relative to the
+/// archive, so the library is only usable from within the cache, and
+/// installing it is an error.
+thin_archive: ?bool = null,
 // keep in sync with src/link.zig:CompressDebugSections
 compress_debug_sections: enum { none, zlib, zstd } = .none,
 verbose_link: bool,
@@ -181,7 +194,10 @@ force_undefined_symbols: std.StringHashMap(void),
 /// Overrides the default stack size
 stack_size: ?u64 = null,
 
+/// Enables or disables Link Time Optimization. `lto` takes precedence,
+/// `want_lto = true` is the same as `lto = .full`.
 want_lto: ?bool = null,
+lto: ?std.zig.LtoMode = null,
 use_llvm: ?bool,
 use_lld: ?bool,
 
@@ -1420,6 +1436,10 @@ fn getZigArgs(compile: *Compile, fuzz: bool) ![][]const u8 {
     if (compile.generated_h != null) try zig_args.append("-femit-h");
 
     try addFlag(&zig_args, "formatted-panics", compile.formatted_panics);
+    try addFlag(&zig_args, "air-optimize", compile.air_optimize);
+    try addFlag(&zig_args, "clang-in-process", compile.clang_in_process);
+    try addFlag(&zig_args, "cimport-skip-function-bodies", compile.cimport_skip_function_bodies);
+    try addFlag(&zig_args, "thin-archive", compile.thin_archive);
 
     switch (compile.compress_debug_sections) {
         .none => {},
@@ -1669,7 +1689,15 @@ fn getZigArgs(compile: *Compile, fuzz: bool) ![][]const u8 {
     }
 
     try addFlag(&zig_args, "PIE", compile.pie);
-    try addFlag(&zig_args, "lto", compile.want_lto);
+    if (compile.lto) |lto| {
+        try zig_args.append(switch (lto) {
+            .none => "-fno-lto",
+            .full => "-flto=full",
+            .thin => "-flto=thin",
+        });
+    } else {
+        try addFlag(&zig_args, "lto", compile.want_lto);
+    }
     try addFlag(&zig_args, "sanitize-coverage-trace-pc-guard", compile.sanitize_coverage_trace_pc_guard);
 
     if (compile.subsystem) |subsystem| {
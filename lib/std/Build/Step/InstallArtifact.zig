@@ -124,6 +124,13 @@ fn make(step: *Step, options: Step.MakeOptions) !void {
     var all_cached = true;
 
     if (install_artifact.dest_dir) |dest_dir| {
+        if (install_artifact.artifact.thin_archive == true) {
+            // The member paths are relative to the archive's location in the
+            // cache, so a copy of the archive elsewhere would not find them.
+            return step.fail("unable to install thin archive '{s}'; it is only usable from within the cache", .{
+                install_artifact.artifact.name,
+            });
+        }
         const full_dest_path = b.getInstallPath(dest_dir, install_artifact.dest_sub_path);
         const full_src_path = install_artifact.emitted_bin.?.getPath2(b, step);
         const p = fs.Dir.updateFile(cwd, full_src_path, cwd, full_dest_path, .{}) catch |err| {
@@ -17,6 +17,7 @@ optimize: std.builtin.OptimizeMode,
 output_file: std.Build.GeneratedFile,
 link_libc: bool,
 use_clang: bool,
+skip_function_bodies: bool,
 
 pub const Options = struct {
     root_source_file: std.Build.LazyPath,
@@ -24,6 +25,9 @@ pub const Options = struct {
     optimize: std.builtin.OptimizeMode,
     link_libc: bool = true,
     use_clang: bool = true,
+    /// Translate function definitions to `@compileError` declarations
+    /// instead of translating their bodies.
+    skip_function_bodies: bool = false,
 };
 
 pub fn create(owner: *std.Build, options: Options) *TranslateC {
@@ -45,6 +49,7 @@ pub fn create(owner: *std.Build, options: Options) *TranslateC {
         .output_file = std.Build.GeneratedFile{ .step = &translate_c.step },
         .link_libc = options.link_libc,
         .use_clang = options.use_clang,
+        .skip_function_bodies = options.skip_function_bodies,
     };
     source.addStepDependencies(&translate_c.step);
     return translate_c;
@@ -130,6 +135,9 @@ fn make(step: *Step, options: Step.MakeOptions) !void {
     if (!translate_c.use_clang) {
         try argv_list.append("-fno-clang");
     }
+    if (translate_c.skip_function_bodies) {
+        try argv_list.append("-fcimport-skip-function-bodies");
+    }
 
     try argv_list.append("--listen=-");
 
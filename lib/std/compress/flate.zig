@@ -39,6 +39,21 @@ pub fn compressor(writer: anytype, options: Options) !Compressor(@TypeOf(writer)
     return try deflate.compressor(.raw, writer, options);
 }
 
+/// Block size and compression level for parallelCompress.
+pub const ParallelOptions = deflate.ParallelOptions;
+
+/// Compress plain data from reader and write compressed data to the writer.
+/// Input is split into blocks which are compressed on the thread pool.
+pub fn parallelCompress(
+    gpa: std.mem.Allocator,
+    thread_pool: *std.Thread.Pool,
+    reader: anytype,
+    writer: anytype,
+    options: ParallelOptions,
+) !void {
+    try deflate.parallelCompress(.raw, gpa, thread_pool, reader, writer, options);
+}
+
 /// Huffman only compression. Without Lempel-Ziv match searching. Faster
 /// compression, less memory requirements but bigger compressed sizes.
 pub const huffman = struct {
@@ -475,3 +490,44 @@ fn testInterface(comptime pkg: type, gzip_data: []const u8, plain_data: []const
         }
     }
 }
+
+test "parallel compress" {
+    if (builtin.single_threaded) return error.SkipZigTest;
+
+    const data = @embedFile("flate/testdata/rfc1951.txt") ** 4;
+    const gzip = @import("gzip.zig");
+    const zlib = @import("zlib.zig");
+    const flate = @This();
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = testing.allocator, .n_jobs = 3 });
+    defer pool.deinit();
+
+    inline for (.{ gzip, zlib, flate }) |pkg| {
+        // Small blocks get history from the previous block in the same batch,
+        // big ones from the previous batch.
+        for ([_]usize{ 1000, 64 * 1024 }) |block_len| {
+            for ([_]deflate.Level{ .fast, .best }) |level| {
+                for ([_][]const u8{ "", data[0..100], &data }) |plain| {
+                    var compressed = std.ArrayList(u8).init(testing.allocator);
+                    defer compressed.deinit();
+                    var plain_in = fixedBufferStream(plain);
+                    try pkg.parallelCompress(testing.allocator, &pool, plain_in.reader(), compressed.writer(), .{
+                        .level = level,
+                        .block_len = block_len,
+                    });
+                    if (plain.len == data.len) {
+                        // Matches are found across block boundaries.
+                        try testing.expect(compressed.items.len < plain.len / 2);
+                    }
+
+                    var decompressed = std.ArrayList(u8).init(testing.allocator);
+                    defer decompressed.deinit();
+                    var compressed_in = fixedBufferStream(compressed.items);
+                    try pkg.decompress(compressed_in.reader(), decompressed.writer());
+                    try testing.expectEqualSlices(u8, plain, decompressed.items);
+                }
+            }
+        }
+    }
+}
@@ -55,6 +55,21 @@ pub fn writeMatch(self: *Self, length: u16, distance: u16) !void {
     var to: usize = self.wp & mask;
     const to_end: usize = to + length;
 
+    // Fast path for non overlapping 8 byte chunks. Copies whole chunks so it
+    // can write up to 7 bytes past the match end, that is safe if that space
+    // is free and in the same circle.
+    if (distance >= 8 and from_end + 8 <= buffer_len and to_end + 8 <= buffer_len and
+        self.free() >= @as(usize, length) + 8)
+    {
+        self.wp += length;
+        var i: usize = 0;
+        while (i < length) : (i += 8) {
+            const chunk = std.mem.readInt(u64, self.buffer[from + i ..][0..8], .little);
+            std.mem.writeInt(u64, self.buffer[to + i ..][0..8], chunk, .little);
+        }
+        return;
+    }
+
     self.wp += length;
 
     // Fast path using memcpy
@@ -156,6 +171,24 @@ test "writeMatch overlap" {
     try testing.expectEqualStrings("a b c b c b c d", cb.read());
 }
 
+test "writeMatch chunks" {
+    var cb: Self = .{};
+
+    cb.writeAll("0123456789");
+    try cb.writeMatch(13, 10);
+    try cb.writeMatch(8, 8);
+    cb.write('a');
+
+    try testing.expectEqualStrings("0123456789" ++ "0123456789012" ++ "56789012" ++ "a", cb.read());
+
+    // Near the end of the buffer, chunks can't be used.
+    cb.wp = cb.buffer.len - 20;
+    cb.rp = cb.wp;
+    cb.writeAll("0123456789");
+    try cb.writeMatch(9, 10);
+    try testing.expectEqualStrings("0123456789012345678", cb.read());
+}
+
 test readAtMost {
     var cb: Self = .{};
 
@@ -0,0 +1,142 @@
+// zig run -O ReleaseFast --zig-lib-dir ../../.. benchmark.zig
+
+const std = @import("std");
+const builtin = @import("builtin");
+const time = std.time;
+const Timer = time.Timer;
+const flate = std.compress.flate;
+
+const KiB = 1024;
+const MiB = 1024 * KiB;
+
+const Level = flate.deflate.Level;
+const levels = [_]Level{ .level_4, .level_5, .level_6, .level_7, .level_8, .level_9 };
+
+const Result = struct {
+    throughput: u64,
+    compressed_len: usize,
+};
+
+fn benchmarkCompress(
+    thread_pool: ?*std.Thread.Pool,
+    input: []const u8,
+    output: *std.ArrayList(u8),
+    level: Level,
+) !Result {
+    const gpa = output.allocator;
+    output.clearRetainingCapacity();
+    var stream = std.io.fixedBufferStream(input);
+
+    var timer = try Timer.start();
+    const start = timer.lap();
+    if (thread_pool) |pool| {
+        try flate.parallelCompress(gpa, pool, stream.reader(), output.writer(), .{ .level = level });
+    } else {
+        try flate.compress(stream.reader(), output.writer(), .{ .level = level });
+    }
+    const end = timer.read();
+
+    const elapsed_s = @as(f64, @floatFromInt(end - start)) / time.ns_per_s;
+    return .{
+        .throughput = @intFromFloat(@as(f64, @floatFromInt(input.len)) / elapsed_s),
+        .compressed_len = output.items.len,
+    };
+}
+
+fn benchmarkDecompress(compressed: []const u8, plain_len: usize) !u64 {
+    var stream = std.io.fixedBufferStream(compressed);
+    var counter = std.io.countingWriter(std.io.null_writer);
+
+    var timer = try Timer.start();
+    const start = timer.lap();
+    try flate.decompress(stream.reader(), counter.writer());
+    const end = timer.read();
+    std.debug.assert(counter.bytes_written == plain_len);
+
+    const elapsed_s = @as(f64, @floatFromInt(end - start)) / time.ns_per_s;
+    return @intFromFloat(@as(f64, @floatFromInt(plain_len)) / elapsed_s);
+}
+
+fn usage() void {
+    std.debug.print(
+        \\benchmark [options]
+        \\
+        \\Compresses 64 MiB of text with flate.compress and with
+        \\flate.parallelCompress at levels 4 through 9, and prints the
+        \\throughput and compression ratio of each, along with the
+        \\decompression throughput.
+        \\
+        \\Options:
+        \\  --jobs [int]  Threads used by parallelCompress (default: CPU count)
+        \\  --help        Print this help and exit
+        \\
+    , .{});
+}
+
+fn mode(comptime x: comptime_int) comptime_int {
+    return if (builtin.mode == .Debug) x / 64 else x;
+}
+
+pub fn main() !void {
+    const stdout = std.io.getStdOut().writer();
+
+    var gpa_state: std.heap.GeneralPurposeAllocator(.{}) = .{};
+    defer _ = gpa_state.deinit();
+    const gpa = gpa_state.allocator();
+
+    const args = try std.process.argsAlloc(gpa);
+    defer std.process.argsFree(gpa, args);
+
+    var n_jobs: ?usize = null;
+
+    var i: usize = 1;
+    while (i < args.len) : (i += 1) {
+        if (std.mem.eql(u8, args[i], "--jobs")) {
+            i += 1;
+            if (i == args.len) {
+                usage();
+                std.process.exit(1);
+            }
+
+            n_jobs = try std.fmt.parseUnsigned(usize, args[i], 10);
+        } else if (std.mem.eql(u8, args[i], "--help")) {
+            usage();
+            return;
+        } else {
+            usage();
+            std.process.exit(1);
+        }
+    }
+
+    // Text compresses similar to the typical source and artifact contents.
+    const text = @embedFile("testdata/rfc1951.txt");
+    const input = try gpa.alloc(u8, mode(64 * MiB));
+    defer gpa.free(input);
+    for (0..input.len / text.len) |j| @memcpy(input[j * text.len ..][0..text.len], text);
+    @memset(input[input.len / text.len * text.len ..], ' ');
+
+    var thread_pool: std.Thread.Pool = undefined;
+    try thread_pool.init(.{ .allocator = gpa, .n_jobs = n_jobs });
+    defer thread_pool.deinit();
+
+    var compressed = try std.ArrayList(u8).initCapacity(gpa, input.len);
+    defer compressed.deinit();
+
+    for (levels) |level| {
+        const parallel = try benchmarkCompress(&thread_pool, input, &compressed, level);
+        const serial = try benchmarkCompress(null, input, &compressed, level);
+        const decompress = try benchmarkDecompress(compressed.items, input.len);
+        try stdout.print("{s:>8}: {:6} MiB/s ({:5.2}%) parallel {:6} MiB/s ({:5.2}%) decompress {:6} MiB/s\n", .{
+            @tagName(level),
+            serial.throughput / MiB,
+            ratio(serial.compressed_len, input.len),
+            parallel.throughput / MiB,
+            ratio(parallel.compressed_len, input.len),
+            decompress / MiB,
+        });
+    }
+}
+
+fn ratio(compressed_len: usize, input_len: usize) f64 {
+    return @as(f64, @floatFromInt(compressed_len)) * 100 / @as(f64, @floatFromInt(input_len));
+}
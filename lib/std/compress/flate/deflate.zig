@@ -73,6 +73,114 @@ pub fn Compressor(comptime container: Container, comptime WriterType: type) type
     return Deflate(container, WriterType, TokenWriterType);
 }
 
+pub const ParallelOptions = struct {
+    level: Level = .default,
+    /// Amount of the uncompressed input compressed by one task. Each block
+    /// ends with a sync flush, so smaller blocks give more parallelism but
+    /// slightly bigger output.
+    block_len: usize = 128 * 1024,
+};
+
+/// Compress plain data from reader into compressed stream written to writer,
+/// splitting input into blocks which are compressed concurrently on the
+/// `thread_pool`. Each block is primed with the last 32K of the preceding
+/// input so the compression ratio stays close to the one of `compress`.
+/// Output is a single valid stream which can be read by any decompressor.
+pub fn parallelCompress(
+    comptime container: Container,
+    gpa: std.mem.Allocator,
+    thread_pool: *std.Thread.Pool,
+    reader: anytype,
+    writer: anytype,
+    options: ParallelOptions,
+) !void {
+    assert(options.block_len > 0);
+    const hist_len = consts.history.len;
+
+    const blocks = try gpa.alloc(ParallelBlock, thread_pool.getIdCount());
+    defer {
+        for (blocks) |*block| block.output.deinit();
+        gpa.free(blocks);
+    }
+    for (blocks) |*block| block.* = .{ .output = std.ArrayList(u8).init(gpa) };
+
+    // History of the previous batch followed by the current batch input.
+    const buffer = try gpa.alloc(u8, hist_len + blocks.len * options.block_len);
+    defer gpa.free(buffer);
+    var dict_len: usize = 0;
+
+    var hasher: container.Hasher() = .{};
+    try container.writeHeader(writer);
+
+    while (true) {
+        const batch = buffer[hist_len..];
+        const n = try reader.readAll(batch);
+        const final = n < batch.len;
+
+        var wait_group: std.Thread.WaitGroup = .{};
+        // The checksum of the batch is computed alongside its blocks.
+        if (container != .raw) thread_pool.spawnWg(&wait_group, parallelHash, .{ &hasher, batch[0..n] });
+        var blocks_len: usize = 0;
+        var start: usize = 0;
+        while (true) {
+            const end = @min(start + options.block_len, n);
+            const block_pos = hist_len + start;
+            const block = &blocks[blocks_len];
+            block.dict = buffer[@max(hist_len - dict_len, block_pos -| hist_len)..block_pos];
+            block.input = buffer[block_pos .. hist_len + end];
+            block.final = final and end == n;
+            blocks_len += 1;
+            thread_pool.spawnWg(&wait_group, parallelCompressBlock, .{ block, options.level });
+            start = end;
+            if (start == n) break;
+        }
+        thread_pool.waitAndWork(&wait_group);
+
+        for (blocks[0..blocks_len]) |block| {
+            try block.result;
+            try writer.writeAll(block.output.items);
+        }
+        if (final) break;
+
+        // Keep the tail of this batch as the history for the next one.
+        const data_end = hist_len + n;
+        const keep = @min(hist_len, dict_len + n);
+        std.mem.copyForwards(u8, buffer[hist_len - keep .. hist_len], buffer[data_end - keep .. data_end]);
+        dict_len = keep;
+    }
+
+    try container.writeFooter(&hasher, writer);
+}
+
+const ParallelBlock = struct {
+    dict: []const u8 = &.{},
+    input: []const u8 = &.{},
+    final: bool = false,
+    output: std.ArrayList(u8),
+    result: (Compressor(.raw, std.ArrayList(u8).Writer).Error || std.mem.Allocator.Error)!void = {},
+};
+
+fn parallelHash(hasher: anytype, bytes: []const u8) void {
+    hasher.update(bytes);
+}
+
+fn parallelCompressBlock(block: *ParallelBlock, level: Level) void {
+    block.result = parallelCompressBlockFallible(block, level);
+}
+
+fn parallelCompressBlockFallible(block: *ParallelBlock, level: Level) !void {
+    const BlockCompressor = Compressor(.raw, std.ArrayList(u8).Writer);
+    block.output.clearRetainingCapacity();
+    // Compressor state is ~400K, keep it off the thread pool stack.
+    const c = try block.output.allocator.create(BlockCompressor);
+    defer block.output.allocator.destroy(c);
+    c.* = try BlockCompressor.init(block.output.writer(), .{ .level = level });
+    c.setDictionary(block.dict);
+    var fbs = io.fixedBufferStream(block.input);
+    try c.compress(fbs.reader());
+    if (block.final) try c.finish() else try c.flush();
+}
+
 /// Default compression algorithm. Has two steps: tokenization and token
 /// encoding.
 ///
@@ -353,6 +461,22 @@ fn Deflate(comptime container: Container, comptime WriterType: type, comptime Bl
             self.wrt = new_writer;
         }
 
+        /// Primes the compressor with history preceding the data which will be
+        /// compressed, so that the first bytes can be encoded as matches into
+        /// `dict`. Only the last 32K of `dict` are used. Must be called before
+        /// any data is written to the compressor. Decompressor has to be
+        /// primed with the same history; when the previous data is part of the
+        /// same deflate stream that is always the case.
+        pub fn setDictionary(self: *Self, dict: []const u8) void {
+            assert(self.win.wp == 0);
+            const d = dict[dict.len -| consts.history.len..];
+            const n = self.win.write(d);
+            assert(n == d.len);
+            self.lookup.bulkAdd(d, @intCast(n), 0);
+            self.win.advance(@intCast(n));
+            self.win.flush();
+        }
+
         // Writer interface
 
         pub const Writer = io.Writer(*Self, Error, write);
@@ -1,4 +1,5 @@
 const std = @import("std");
+const assert = std.debug.assert;
 const testing = std.testing;
 
 pub const Symbol = packed struct {
@@ -28,6 +29,13 @@ pub const Symbol = packed struct {
     }
 };
 
+/// Two literals decoded with a single lookup. `code_bits` is the sum of both
+/// code lengths, 0 if the code doesn't start with two short literal codes.
+pub const LiteralPair = struct {
+    literals: [2]u8 = .{ 0, 0 },
+    code_bits: u4 = 0,
+};
+
 pub const LiteralDecoder = HuffmanDecoder(286, 15, 9);
 pub const DistanceDecoder = HuffmanDecoder(30, 15, 9);
 pub const CodegenDecoder = HuffmanDecoder(19, 7, 7);
@@ -58,12 +66,20 @@ fn HuffmanDecoder(
     comptime lookup_bits: u4,
 ) type {
     const lookup_shift = max_code_bits - lookup_bits;
+    // Literal/length alphabet also gets table of literal pairs.
+    const has_pairs = alphabet_size == 286;
+    const pair_bits = 12;
+    const pair_shift = max_code_bits - pair_bits;
+    const code_mask: u16 = (1 << max_code_bits) - 1;
 
     return struct {
         // all symbols in alaphabet, sorted by code_len, symbol
         symbols: [alphabet_size]Symbol = undefined,
         // lookup table code -> symbol
         lookup: [1 << lookup_bits]Symbol = undefined,
+        // lookup table code -> two literals, for codes where first pair_bits
+        // bits are enough to decode two literals
+        pairs: if (has_pairs) [1 << pair_bits]LiteralPair else void = undefined,
 
         const Self = @This();
 
@@ -115,6 +131,30 @@ fn HuffmanDecoder(
                 idx = next_idx;
                 code = next_code;
             }
+
+            if (has_pairs) self.generatePairs();
+        }
+
+        // Fills pairs table from the lookup table. For each pair_bits long
+        // code prefix first literal is decoded from lookup and then the second
+        // one from the bits remaining after the first code.
+        fn generatePairs(self: *Self) void {
+            for (&self.pairs, 0..) |*pair, i| {
+                pair.* = .{};
+                const code: u16 = @intCast(i << pair_shift);
+                const first = self.lookup[code >> lookup_shift];
+                if (first.kind != .literal or first.code_bits == 0) continue;
+                const rest = (code << first.code_bits) & code_mask;
+                const second = self.lookup[rest >> lookup_shift];
+                if (second.kind != .literal or second.code_bits == 0) continue;
+                // Second code has to fit into the pair_bits prefix.
+                const code_bits = @as(u5, first.code_bits) + second.code_bits;
+                if (code_bits > pair_bits) continue;
+                pair.* = .{
+                    .literals = .{ first.symbol, second.symbol },
+                    .code_bits = @intCast(code_bits),
+                };
+            }
         }
 
         /// Given the list of code lengths check that it represents a canonical
@@ -160,6 +200,13 @@ fn HuffmanDecoder(
             return self.findLinked(code, sym.next);
         }
 
+        /// Finds two literals for code, code_bits of the result is 0 if
+        /// the code doesn't start with two literals short enough.
+        pub fn findPair(self: *Self, code: u16) LiteralPair {
+            comptime assert(has_pairs);
+            return self.pairs[code >> pair_shift];
+        }
+
         inline fn findLinked(self: *Self, code: u16, start: u16) !Symbol {
             var pos = start;
             while (pos > 0) {
@@ -300,3 +347,31 @@ test "encode/decode literals" {
         }
     }
 }
+
+test findPair {
+    var code_lens = [_]u4{0} ** 286;
+    for ("abc", [_]u4{ 2, 2, 3 }) |c, len| code_lens[c] = len;
+    code_lens['d'] = 11;
+    code_lens[256] = 2;
+    for (257..265, [_]u4{ 4, 5, 6, 7, 8, 9, 10, 11 }) |i, len| code_lens[i] = len;
+    var dec: LiteralDecoder = .{};
+    try dec.generate(&code_lens);
+
+    // Codes: a 00, b 01, end_of_block 10, c 110, first match 1110,
+    // d 11111111110.
+    const ab = dec.findPair(0b00_01_00000000000);
+    try testing.expectEqual(4, ab.code_bits);
+    try testing.expectEqualSlices(u8, "ab", &ab.literals);
+    const ca = dec.findPair(0b110_00_0000000000);
+    try testing.expectEqual(5, ca.code_bits);
+    try testing.expectEqualSlices(u8, "ca", &ca.literals);
+
+    // Second symbol is not literal.
+    try testing.expectEqual(0, dec.findPair(0b00_10_00000000000).code_bits);
+    try testing.expectEqual(0, dec.findPair(0b00_1110_000000000).code_bits);
+    // First symbol is not literal.
+    try testing.expectEqual(0, dec.findPair(0b10_00_00000000000).code_bits);
+    // Code of the second literal doesn't fit into the pair table.
+    try testing.expectEqual('d', (try dec.find(0b11111111110_0000)).symbol);
+    try testing.expectEqual(0, dec.findPair(0b00_11111111110_00).code_bits);
+}
@@ -44,9 +44,9 @@ pub fn Decompressor(comptime container: Container, comptime ReaderType: type) ty
 /// `step` function runs decoder until internal `hist` buffer is full. Client
 /// than needs to read that data in order to proceed with decoding.
 ///
-/// Allocates 74.5K of internal buffers, most important are:
+/// Allocates 86.5K of internal buffers, most important are:
 ///   * 64K for history (CircularBuffer)
-///   * ~10K huffman decoders (Literal and DistanceDecoder)
+///   * ~22K huffman decoders (Literal and DistanceDecoder)
 ///
 pub fn Inflate(comptime container: Container, comptime LookaheadType: type, comptime ReaderType: type) type {
     assert(LookaheadType == u32 or LookaheadType == u64);
@@ -225,7 +225,19 @@ pub fn Inflate(comptime container: Container, comptime LookaheadType: type, comp
             // Hot path loop!
             while (!self.hist.full()) {
                 try self.bits.fill(15); // optimization so other bit reads can be buffered (avoiding one `if` in hot path)
-                const sym = try self.decodeSymbol(&self.lit_dec);
+                const code = try self.bits.peekF(u15, F.buffered | F.reverse);
+
+                // Most common case, two short literal codes, decoded with single lookup.
+                const pair = self.lit_dec.findPair(code);
+                if (pair.code_bits != 0) {
+                    try self.bits.shift(pair.code_bits);
+                    self.hist.write(pair.literals[0]);
+                    self.hist.write(pair.literals[1]);
+                    continue;
+                }
+
+                const sym = try self.lit_dec.find(code);
+                try self.bits.shift(sym.code_bits);
 
                 switch (sym.kind) {
                     .literal => self.hist.write(sym.symbol),
@@ -1,3 +1,4 @@
+const std = @import("std");
 const deflate = @import("flate/deflate.zig");
 const inflate = @import("flate/inflate.zig");
 
@@ -34,6 +35,21 @@ pub fn compressor(writer: anytype, options: Options) !Compressor(@TypeOf(writer)
     return try deflate.compressor(.gzip, writer, options);
 }
 
+/// Block size and compression level for parallelCompress.
+pub const ParallelOptions = deflate.ParallelOptions;
+
+/// Compress plain data from reader and write compressed data to the writer.
+/// Input is split into blocks which are compressed on the thread pool.
+pub fn parallelCompress(
+    gpa: std.mem.Allocator,
+    thread_pool: *std.Thread.Pool,
+    reader: anytype,
+    writer: anytype,
+    options: ParallelOptions,
+) !void {
+    try deflate.parallelCompress(.gzip, gpa, thread_pool, reader, writer, options);
+}
+
 /// Huffman only compression. Without Lempel-Ziv match searching. Faster
 /// compression, less memory requirements but bigger compressed sizes.
 pub const huffman = struct {
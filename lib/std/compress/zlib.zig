@@ -1,3 +1,4 @@
+const std = @import("std");
 const deflate = @import("flate/deflate.zig");
 const inflate = @import("flate/inflate.zig");
 
@@ -34,6 +35,21 @@ pub fn compressor(writer: anytype, options: Options) !Compressor(@TypeOf(writer)
     return try deflate.compressor(.zlib, writer, options);
 }
 
+/// Block size and compression level for parallelCompress.
+pub const ParallelOptions = deflate.ParallelOptions;
+
+/// Compress plain data from reader and write compressed data to the writer.
+/// Input is split into blocks which are compressed on the thread pool.
+pub fn parallelCompress(
+    gpa: std.mem.Allocator,
+    thread_pool: *std.Thread.Pool,
+    reader: anytype,
+    writer: anytype,
+    options: ParallelOptions,
+) !void {
+    try deflate.parallelCompress(.zlib, gpa, thread_pool, reader, writer, options);
+}
+
 /// Huffman only compression. Without Lempel-Ziv match searching. Faster
 /// compression, less memory requirements but bigger compressed sizes.
 pub const huffman = struct {
@@ -66,8 +82,6 @@ pub const store = struct {
 };
 
 test "should not overshoot" {
-    const std = @import("std");
-
     // Compressed zlib data with extra 4 bytes at the end.
     const data = [_]u8{
         0x78, 0x9c, 0x73, 0xce, 0x2f, 0xa8, 0x2c, 0xca, 0x4c, 0xcf, 0x28, 0x51, 0x08, 0xcf, 0xcc, 0xc9,
@@ -619,6 +619,279 @@ pub const Request = struct {
         };
     }
 
+    pub const RespondFileOptions = struct {
+        /// Options that are shared with the `respond` method.
+        /// `transfer_encoding` must be `null`; the "content-length" header is
+        /// always used. When a range of the file is served, `status` and
+        /// `reason` are replaced with the appropriate partial content status.
+        respond_options: RespondOptions = .{},
+        /// Size of the file in bytes. `null` means the file is stat'd to find
+        /// out. Passing the size here saves one syscall.
+        size: ?u64 = null,
+        /// When enabled and `respond_options.status` is `ok`, a single byte
+        /// range requested with the "range" header is honored with a 206
+        /// response, and the response advertises "accept-ranges: bytes".
+        ranges: bool = true,
+    };
+
+    pub const RespondFileError = Response.WriteError ||
+        std.fs.File.StatError ||
+        std.fs.File.PReadError ||
+        std.fs.File.WriteFileError;
+
+    /// Send an HTTP response to the client whose body is the contents of
+    /// `file`, including headers.
+    ///
+    /// Where the operating system supports it, the file contents are copied
+    /// to the connection by the kernel with `sendfile` rather than passing
+    /// through a userspace buffer, and the headers are sent along with the
+    /// first part of the body.
+    ///
+    /// Automatically handles HEAD requests by omitting the body.
+    ///
+    /// See `respond` for how the request body is handled.
+    ///
+    /// Asserts status is not `continue`.
+    /// Asserts `transfer_encoding` is `null`.
+    /// Asserts there are at most 25 extra_headers.
+    /// Asserts that "\r\n" does not occur in any header name or value.
+    pub fn respondFile(
+        request: *Request,
+        file: std.fs.File,
+        options: RespondFileOptions,
+    ) RespondFileError!void {
+        const max_extra_headers = 25;
+        const o = options.respond_options;
+        assert(o.status != .@"continue");
+        assert(o.transfer_encoding == null);
+        assert(o.extra_headers.len <= max_extra_headers);
+        if (std.debug.runtime_safety) {
+            for (o.extra_headers) |header| {
+                assert(header.name.len != 0);
+                assert(std.mem.indexOfScalar(u8, header.name, ':') == null);
+                assert(std.mem.indexOfPosLinear(u8, header.name, 0, "\r\n") == null);
+                assert(std.mem.indexOfPosLinear(u8, header.value, 0, "\r\n") == null);
+            }
+        }
+
+        const size = options.size orelse (try file.stat()).size;
+        const range: ContentRange = if (options.ranges and o.status == .ok)
+            request.contentRange(size)
+        else
+            .full;
+
+        const keep_alive = request.discardBody(o.keep_alive);
+        const stream = request.server.connection.stream;
+
+        var first_buffer: [500]u8 = undefined;
+        var h = std.ArrayListUnmanaged(u8).initBuffer(&first_buffer);
+        if (request.head.expect != null) {
+            // reader() and hence discardBody() above sets expect to null if it
+            // is handled. So the fact that it is not null here means unhandled.
+            h.appendSliceAssumeCapacity("HTTP/1.1 417 Expectation Failed\r\n");
+            if (!keep_alive) h.appendSliceAssumeCapacity("connection: close\r\n");
+            h.appendSliceAssumeCapacity("content-length: 0\r\n\r\n");
+            try stream.writeAll(h.items);
+            return;
+        }
+
+        const status: http.Status = switch (range) {
+            .full => o.status,
+            .partial => .partial_content,
+            .unsatisfiable => .range_not_satisfiable,
+        };
+        const phrase = switch (range) {
+            .full => o.reason orelse status.phrase() orelse "",
+            .partial, .unsatisfiable => status.phrase().?,
+        };
+        h.fixedWriter().print("{s} {d} {s}\r\n", .{
+            @tagName(o.version), @intFromEnum(status), phrase,
+        }) catch unreachable;
+
+        switch (o.version) {
+            .@"HTTP/1.0" => if (keep_alive) h.appendSliceAssumeCapacity("connection: keep-alive\r\n"),
+            .@"HTTP/1.1" => if (!keep_alive) h.appendSliceAssumeCapacity("connection: close\r\n"),
+        }
+
+        if (options.ranges) h.appendSliceAssumeCapacity("accept-ranges: bytes\r\n");
+
+        var body_start: u64 = 0;
+        var body_len: u64 = 0;
+        switch (range) {
+            .full => body_len = size,
+            .partial => |p| {
+                body_start = p.start;
+                body_len = p.len;
+                h.fixedWriter().print("content-range: bytes {d}-{d}/{d}\r\n", .{
+                    p.start, p.start + p.len - 1, size,
+                }) catch unreachable;
+            },
+            .unsatisfiable => {
+                h.fixedWriter().print("content-range: bytes */{d}\r\n", .{size}) catch unreachable;
+            },
+        }
+        h.fixedWriter().print("content-length: {d}\r\n", .{body_len}) catch unreachable;
+
+        var iovecs: [max_extra_headers * 4 + 2]std.posix.iovec_const = undefined;
+        var iovecs_len: usize = 0;
+
+        iovecs[iovecs_len] = .{
+            .base = h.items.ptr,
+            .len = h.items.len,
+        };
+        iovecs_len += 1;
+
+        for (o.extra_headers) |header| {
+            iovecs[iovecs_len] = .{
+                .base = header.name.ptr,
+                .len = header.name.len,
+            };
+            iovecs_len += 1;
+
+            iovecs[iovecs_len] = .{
+                .base = ": ",
+                .len = 2,
+            };
+            iovecs_len += 1;
+
+            if (header.value.len != 0) {
+                iovecs[iovecs_len] = .{
+                    .base = header.value.ptr,
+                    .len = header.value.len,
+                };
+                iovecs_len += 1;
+            }
+
+            iovecs[iovecs_len] = .{
+                .base = "\r\n",
+                .len = 2,
+            };
+            iovecs_len += 1;
+        }
+
+        iovecs[iovecs_len] = .{
+            .base = "\r\n",
+            .len = 2,
+        };
+        iovecs_len += 1;
+
+        if (request.head.method == .HEAD or body_len == 0) {
+            try stream.writevAll(iovecs[0..iovecs_len]);
+            return;
+        }
+
+        if (native_os == .windows) {
+            // Sockets are not interchangeable with file handles here, so the
+            // contents are copied through a buffer instead.
+            try stream.writevAll(iovecs[0..iovecs_len]);
+            var buffer: [8192]u8 = undefined;
+            var offset = body_start;
+            const end = body_start + body_len;
+            while (offset < end) {
+                const n = try file.pread(buffer[0..@min(buffer.len, end - offset)], offset);
+                if (n == 0) return error.EndOfStream;
+                try stream.writeAll(buffer[0..n]);
+                offset += n;
+            }
+            return;
+        }
+
+        const out: std.fs.File = .{ .handle = stream.handle };
+        try out.writeFileAll(file, .{
+            .in_offset = body_start,
+            .in_len = body_len,
+            .headers_and_trailers = iovecs[0..iovecs_len],
+            .header_count = iovecs_len,
+        });
+    }
+
+    /// The portion of a representation to send in response to a request,
+    /// according to its "range" header.
+    pub const ContentRange = union(enum) {
+        /// Send the entire representation.
+        full,
+        /// Send `len` bytes starting at `start`. `len` is never zero.
+        partial: struct { start: u64, len: u64 },
+        /// None of the requested bytes exist in the representation.
+        unsatisfiable,
+
+        /// Interprets the value of a "range" header for a representation that
+        /// is `size` bytes long.
+        ///
+        /// Only a single byte range is supported. Multiple ranges, other
+        /// units, and malformed values result in `full`, which is permitted
+        /// by RFC 9110, Section 14.2.
+        pub fn parse(value: []const u8, size: u64) ContentRange {
+            const prefix = "bytes=";
+            if (value.len < prefix.len or !std.ascii.eqlIgnoreCase(value[0..prefix.len], prefix))
+                return .full;
+            const spec = mem.trim(u8, value[prefix.len..], " \t");
+            if (mem.indexOfScalar(u8, spec, ',') != null) return .full;
+            const dash = mem.indexOfScalar(u8, spec, '-') orelse return .full;
+            const first = spec[0..dash];
+            const last = spec[dash + 1 ..];
+
+            if (first.len == 0) {
+                // "bytes=-N" requests the last N bytes.
+                const suffix_len = parseRangeInt(last) orelse return .full;
+                if (suffix_len == 0 or size == 0) return .unsatisfiable;
+                const len = @min(suffix_len, size);
+                return .{ .partial = .{ .start = size - len, .len = len } };
+            }
+
+            const start = parseRangeInt(first) orelse return .full;
+            const end = if (last.len == 0) std.math.maxInt(u64) else parseRangeInt(last) orelse return .full;
+            if (end < start) return .full;
+            if (start >= size) return .unsatisfiable;
+            return .{ .partial = .{ .start = start, .len = @min(end, size - 1) - start + 1 } };
+        }
+
+        fn parseRangeInt(bytes: []const u8) ?u64 {
+            if (bytes.len == 0) return null;
+            for (bytes) |byte| switch (byte) {
+                '0'...'9' => {},
+                else => return null,
+            };
+            return std.fmt.parseInt(u64, bytes, 10) catch null;
+        }
+
+        test parse {
+            const expectEqual = testing.expectEqual;
+            try expectEqual(ContentRange{ .partial = .{ .start = 0, .len = 100 } }, parse("bytes=0-", 100));
+            try expectEqual(ContentRange{ .partial = .{ .start = 10, .len = 11 } }, parse("bytes=10-20", 100));
+            try expectEqual(ContentRange{ .partial = .{ .start = 90, .len = 10 } }, parse("bytes=90-200", 100));
+            try expectEqual(ContentRange{ .partial = .{ .start = 70, .len = 30 } }, parse("bytes=-30", 100));
+            try expectEqual(ContentRange{ .partial = .{ .start = 0, .len = 100 } }, parse("BYTES=-300", 100));
+            try expectEqual(.unsatisfiable, parse("bytes=100-", 100));
+            try expectEqual(.unsatisfiable, parse("bytes=-0", 100));
+            try expectEqual(.unsatisfiable, parse("bytes=0-", 0));
+            try expectEqual(.full, parse("bytes=20-10", 100));
+            try expectEqual(.full, parse("bytes=0-1,5-6", 100));
+            try expectEqual(.full, parse("items=0-1", 100));
+            try expectEqual(.full, parse("bytes=+1-2", 100));
+            try expectEqual(.full, parse("bytes=", 100));
+        }
+    };
+
+    /// Determines which part of a representation that is `size` bytes long
+    /// should be sent, based on the "range" and "if-range" request headers.
+    ///
+    /// Since the server has no validator to compare against, a request with
+    /// an "if-range" header receives the full representation.
+    pub fn contentRange(request: *Request, size: u64) ContentRange {
+        var range: ?[]const u8 = null;
+        var it = request.iterateHeaders();
+        while (it.next()) |header| {
+            if (std.ascii.eqlIgnoreCase(header.name, "range")) {
+                if (range != null) return .full;
+                range = header.value;
+            } else if (std.ascii.eqlIgnoreCase(header.name, "if-range")) {
+                return .full;
+            }
+        }
+        return ContentRange.parse(range orelse return .full, size);
+    }
+
     pub const ReadError = net.Stream.ReadError || error{
         HttpChunkInvalid,
         HttpHeadersOversize,
@@ -1144,5 +1417,6 @@ const net = std.net;
 const Uri = std.Uri;
 const assert = std.debug.assert;
 const testing = std.testing;
+const native_os = @import("builtin").os.tag;
 
 const Server = @This();
@@ -295,6 +295,79 @@ test "Server.Request.respondStreaming non-chunked, unknown content-length" {
     try expectEqualStrings(expected_response.items, response);
 }
 
+test "Server.Request.respondFile with and without range" {
+    const test_server = try createTestServer(struct {
+        fn run(net_server: *std.net.Server) anyerror!void {
+            var tmp = std.testing.tmpDir(.{});
+            defer tmp.cleanup();
+            try tmp.dir.writeFile(.{ .sub_path = "file.txt", .data = "0123456789" });
+            const file = try tmp.dir.openFile("file.txt", .{});
+            defer file.close();
+
+            var header_buffer: [1000]u8 = undefined;
+            const conn = try net_server.accept();
+            defer conn.stream.close();
+
+            var server = http.Server.init(conn, &header_buffer);
+            while (server.state == .ready) {
+                var request = server.receiveHead() catch |err| switch (err) {
+                    error.HttpConnectionClosing => break,
+                    else => |e| return e,
+                };
+                try request.respondFile(file, .{
+                    .respond_options = .{
+                        .extra_headers = &.{
+                            .{ .name = "content-type", .value = "text/plain" },
+                        },
+                    },
+                });
+            }
+        }
+    });
+    defer test_server.destroy();
+
+    const request_bytes =
+        "GET /file.txt HTTP/1.1\r\n\r\n" ++
+        "GET /file.txt HTTP/1.1\r\nrange: bytes=2-4\r\n\r\n" ++
+        "HEAD /file.txt HTTP/1.1\r\nrange: bytes=-3\r\n\r\n" ++
+        "GET /file.txt HTTP/1.1\r\nrange: bytes=10-\r\nconnection: close\r\n\r\n";
+    const gpa = std.testing.allocator;
+    const stream = try std.net.tcpConnectToHost(gpa, "127.0.0.1", test_server.port());
+    defer stream.close();
+    try stream.writeAll(request_bytes);
+
+    const expected_response =
+        "HTTP/1.1 200 OK\r\n" ++
+        "accept-ranges: bytes\r\n" ++
+        "content-length: 10\r\n" ++
+        "content-type: text/plain\r\n" ++
+        "\r\n" ++
+        "0123456789" ++
+        "HTTP/1.1 206 Partial Content\r\n" ++
+        "accept-ranges: bytes\r\n" ++
+        "content-range: bytes 2-4/10\r\n" ++
+        "content-length: 3\r\n" ++
+        "content-type: text/plain\r\n" ++
+        "\r\n" ++
+        "234" ++
+        "HTTP/1.1 206 Partial Content\r\n" ++
+        "accept-ranges: bytes\r\n" ++
+        "content-range: bytes 7-9/10\r\n" ++
+        "content-length: 3\r\n" ++
+        "content-type: text/plain\r\n" ++
+        "\r\n" ++
+        "HTTP/1.1 416 Range Not Satisfiable\r\n" ++
+        "connection: close\r\n" ++
+        "accept-ranges: bytes\r\n" ++
+        "content-range: bytes */10\r\n" ++
+        "content-length: 0\r\n" ++
+        "content-type: text/plain\r\n" ++
+        "\r\n";
+    const response = try stream.reader().readAllAlloc(gpa, 8192);
+    defer gpa.free(response);
+    try expectEqualStrings(expected_response, response);
+}
+
 test "receiving arbitrary http headers from the client" {
     const test_server = try createTestServer(struct {
         fn run(net_server: *std.net.Server) anyerror!void {
@@ -51,7 +51,9 @@ pub const Diagnostics = struct {
         },
     };
 
-    fn findRoot(d: *Diagnostics, path: []const u8) !void {
+    /// Updates `root_dir` to account for an entry at `path`. Used by
+    /// `pipeToFileSystem` and by code which unpacks an `iterator` itself.
+    pub fn findRoot(d: *Diagnostics, path: []const u8) !void {
         if (path.len == 0) return;
 
         d.entries += 1;
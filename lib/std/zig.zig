@@ -35,6 +35,16 @@ pub const c_translation = @import("zig/c_translation.zig");
 pub const SrcHasher = std.crypto.hash.Blake3;
 pub const SrcHash = [16]u8;
 
+/// Link Time Optimization mode.
+pub const LtoMode = enum {
+    none,
+    /// Whole program is merged into one module at link time.
+    full,
+    /// Modules are optimized separately and in parallel, using summaries of
+    /// the whole program to import functions across modules.
+    thin,
+};
+
 pub const Color = enum {
     /// Determine whether stderr is a terminal or not automatically.
     auto,
@@ -676,6 +686,7 @@ pub const EnvVar = enum {
     ZIG_GLOBAL_CACHE_DIR,
     ZIG_LOCAL_CACHE_DIR,
     ZIG_LIB_DIR,
+    ZIG_RUNTIME_STORE,
     ZIG_LIBC,
     ZIG_BUILD_RUNNER,
     ZIG_VERBOSE_LINK,
@@ -0,0 +1,379 @@
+//! Optional AIR-to-AIR optimizations which run between Sema and codegen,
+//! enabled with `-fair-optimize`. Everything here rewrites instructions in
+//! place and must run before `Liveness.analyze`.
+//!
+//! Currently this removes safety checks whose condition is already known to
+//! be true, because an identical check or a `cond_br` on an equivalent
+//! condition dominates it. For example, in
+//!
+//!     if (i < s.len) return s[i] + s[i];
+//!
+//! both bounds checks are removed. Equivalent conditions are found by value
+//! numbering a small set of pure instructions.
+
+gpa: std.mem.Allocator,
+air: Air,
+/// Maps a pure instruction to an earlier, dominating instruction which
+/// computes the same value. Since every use of an instruction is dominated
+/// by it, entries never need to be removed.
+replacements: std.AutoHashMapUnmanaged(Air.Inst.Index, Air.Inst.Ref) = .{},
+/// Pure instructions visible at the current point, keyed by value.
+values: std.AutoHashMapUnmanaged(ValueKey, Air.Inst.Index) = .{},
+/// Boolean values known to be true at the current point.
+facts: std.AutoHashMapUnmanaged(Air.Inst.Ref, void) = .{},
+/// Entries added to `values` and `facts`, so that they can be removed when
+/// leaving the body which established them.
+values_undo: std.ArrayListUnmanaged(ValueKey) = .{},
+facts_undo: std.ArrayListUnmanaged(Air.Inst.Ref) = .{},
+elided_safety_checks: u32 = 0,
+
+const ValueKey = struct {
+    tag: Air.Inst.Tag,
+    a: Air.Inst.Ref,
+    b: Air.Inst.Ref,
+};
+
+pub fn run(gpa: std.mem.Allocator, air: Air) Allocator.Error!void {
+    var opt: Optimize = .{ .gpa = gpa, .air = air };
+    defer opt.deinit();
+    try opt.optimizeBody(air.getMainBody());
+    if (opt.elided_safety_checks > 0) log.debug("elided {d} safety checks", .{opt.elided_safety_checks});
+}
+
+fn deinit(opt: *Optimize) void {
+    opt.replacements.deinit(opt.gpa);
+    opt.values.deinit(opt.gpa);
+    opt.facts.deinit(opt.gpa);
+    opt.values_undo.deinit(opt.gpa);
+    opt.facts_undo.deinit(opt.gpa);
+    opt.* = undefined;
+}
+
+fn optimizeBody(opt: *Optimize, body: []const Air.Inst.Index) Allocator.Error!void {
+    const values_len = opt.values_undo.items.len;
+    const facts_len = opt.facts_undo.items.len;
+    defer opt.restore(values_len, facts_len);
+
+    const tags = opt.air.instructions.items(.tag);
+    const data = opt.air.instructions.items(.data);
+    for (body) |inst| switch (tags[@intFromEnum(inst)]) {
+        .cmp_lt,
+        .cmp_lte,
+        .cmp_eq,
+        .cmp_gte,
+        .cmp_gt,
+        .cmp_neq,
+        .bool_and,
+        .bool_or,
+        => |tag| {
+            const bin_op = data[@intFromEnum(inst)].bin_op;
+            try opt.numberValue(inst, .{ .tag = tag, .a = opt.canonical(bin_op.lhs), .b = opt.canonical(bin_op.rhs) });
+        },
+        .not,
+        .intcast,
+        .slice_len,
+        .slice_ptr,
+        => |tag| {
+            const ty_op = data[@intFromEnum(inst)].ty_op;
+            try opt.numberValue(inst, .{ .tag = tag, .a = ty_op.ty, .b = opt.canonical(ty_op.operand) });
+        },
+        .block => {
+            const ty_pl = data[@intFromEnum(inst)].ty_pl;
+            const extra = opt.air.extraData(Air.Block, ty_pl.payload);
+            const block_body: []const Air.Inst.Index = @ptrCast(opt.air.extra[extra.end..][0..extra.data.body_len]);
+            if (opt.safetyCheckCondition(inst, block_body)) |ok| {
+                if (opt.facts.contains(ok)) {
+                    // Unconditionally take the branch which exits the block. The
+                    // failure body is no longer referenced and will not be lowered.
+                    tags[@intFromEnum(block_body[0])] = .br;
+                    data[@intFromEnum(block_body[0])] = .{ .br = .{
+                        .block_inst = inst,
+                        .operand = .void_value,
+                    } };
+                    opt.elided_safety_checks += 1;
+                } else {
+                    try opt.optimizeBody(block_body);
+                }
+                // Code after the check only runs if the condition held.
+                try opt.addFact(ok);
+                continue;
+            }
+            try opt.optimizeBody(block_body);
+        },
+        .dbg_inline_block => {
+            const ty_pl = data[@intFromEnum(inst)].ty_pl;
+            const extra = opt.air.extraData(Air.DbgInlineBlock, ty_pl.payload);
+            try opt.optimizeBody(@ptrCast(opt.air.extra[extra.end..][0..extra.data.body_len]));
+        },
+        .loop => {
+            const ty_pl = data[@intFromEnum(inst)].ty_pl;
+            const extra = opt.air.extraData(Air.Block, ty_pl.payload);
+            try opt.optimizeBody(@ptrCast(opt.air.extra[extra.end..][0..extra.data.body_len]));
+        },
+        .cond_br => {
+            const pl_op = data[@intFromEnum(inst)].pl_op;
+            const extra = opt.air.extraData(Air.CondBr, pl_op.payload);
+            const then_body: []const Air.Inst.Index = @ptrCast(opt.air.extra[extra.end..][0..extra.data.then_body_len]);
+            const else_body: []const Air.Inst.Index = @ptrCast(opt.air.extra[extra.end + then_body.len ..][0..extra.data.else_body_len]);
+            {
+                const facts_len = opt.facts_undo.items.len;
+                defer opt.restore(opt.values_undo.items.len, facts_len);
+                try opt.addFact(opt.canonical(pl_op.operand));
+                try opt.optimizeBody(then_body);
+            }
+            try opt.optimizeBody(else_body);
+        },
+        .@"try" => {
+            const pl_op = data[@intFromEnum(inst)].pl_op;
+            const extra = opt.air.extraData(Air.Try, pl_op.payload);
+            try opt.optimizeBody(@ptrCast(opt.air.extra[extra.end..][0..extra.data.body_len]));
+        },
+        .try_ptr => {
+            const ty_pl = data[@intFromEnum(inst)].ty_pl;
+            const extra = opt.air.extraData(Air.TryPtr, ty_pl.payload);
+            try opt.optimizeBody(@ptrCast(opt.air.extra[extra.end..][0..extra.data.body_len]));
+        },
+        .switch_br => {
+            const pl_op = data[@intFromEnum(inst)].pl_op;
+            const switch_br = opt.air.extraData(Air.SwitchBr, pl_op.payload);
+            var extra_index = switch_br.end;
+            for (0..switch_br.data.cases_len) |_| {
+                const case = opt.air.extraData(Air.SwitchBr.Case, extra_index);
+                const case_body: []const Air.Inst.Index = @ptrCast(opt.air.extra[case.end + case.data.items_len ..][0..case.data.body_len]);
+                extra_index = case.end + case.data.items_len + case_body.len;
+                try opt.optimizeBody(case_body);
+            }
+            try opt.optimizeBody(@ptrCast(opt.air.extra[extra_index..][0..switch_br.data.else_body_len]));
+        },
+        else => {},
+    };
+}
+
+/// Recognizes the shape emitted by `Sema.addSafetyCheckExtra`: a void block
+/// containing only a `cond_br` whose "then" body breaks out of the block and
+/// whose "else" body is `noreturn`. Returns the canonical condition.
+fn safetyCheckCondition(opt: *Optimize, block_inst: Air.Inst.Index, block_body: []const Air.Inst.Index) ?Air.Inst.Ref {
+    const tags = opt.air.instructions.items(.tag);
+    const data = opt.air.instructions.items(.data);
+    if (data[@intFromEnum(block_inst)].ty_pl.ty != .void_type) return null;
+    if (block_body.len != 1 or tags[@intFromEnum(block_body[0])] != .cond_br) return null;
+
+    const pl_op = data[@intFromEnum(block_body[0])].pl_op;
+    const extra = opt.air.extraData(Air.CondBr, pl_op.payload);
+    if (extra.data.then_body_len != 1 or extra.data.else_body_len == 0) return null;
+    const then_body: []const Air.Inst.Index = @ptrCast(opt.air.extra[extra.end..][0..1]);
+    const else_body: []const Air.Inst.Index = @ptrCast(opt.air.extra[extra.end + 1 ..][0..extra.data.else_body_len]);
+
+    if (tags[@intFromEnum(then_body[0])] != .br) return null;
+    const br = data[@intFromEnum(then_body[0])].br;
+    if (br.block_inst != block_inst or br.operand != .void_value) return null;
+
+    switch (tags[@intFromEnum(else_body[else_body.len - 1])]) {
+        .unreach, .trap => {},
+        else => return null,
+    }
+    return opt.canonical(pl_op.operand);
+}
+
+fn canonical(opt: *Optimize, ref: Air.Inst.Ref) Air.Inst.Ref {
+    const inst = ref.toIndex() orelse return ref;
+    return opt.replacements.get(inst) orelse ref;
+}
+
+fn numberValue(opt: *Optimize, inst: Air.Inst.Index, key: ValueKey) Allocator.Error!void {
+    try opt.values_undo.ensureUnusedCapacity(opt.gpa, 1);
+    const gop = try opt.values.getOrPut(opt.gpa, key);
+    if (gop.found_existing) {
+        try opt.replacements.put(opt.gpa, inst, gop.value_ptr.toRef());
+    } else {
+        gop.value_ptr.* = inst;
+        opt.values_undo.appendAssumeCapacity(key);
+    }
+}
+
+fn addFact(opt: *Optimize, ok: Air.Inst.Ref) Allocator.Error!void {
+    try opt.facts_undo.ensureUnusedCapacity(opt.gpa, 1);
+    const gop = try opt.facts.getOrPut(opt.gpa, ok);
+    if (!gop.found_existing) opt.facts_undo.appendAssumeCapacity(ok);
+}
+
+fn restore(opt: *Optimize, values_len: usize, facts_len: usize) void {
+    for (opt.values_undo.items[values_len..]) |key| assert(opt.values.remove(key));
+    opt.values_undo.shrinkRetainingCapacity(values_len);
+    for (opt.facts_undo.items[facts_len..]) |ok| assert(opt.facts.remove(ok));
+    opt.facts_undo.shrinkRetainingCapacity(facts_len);
+}
+
+/// Builds AIR by hand for the tests below.
+const TestAir = struct {
+    instructions: std.MultiArrayList(Air.Inst) = .{},
+    /// The first element is reserved for `Air.ExtraIndex.main_block`.
+    extra: std.ArrayListUnmanaged(u32) = .{},
+
+    fn deinit(t: *TestAir) void {
+        t.instructions.deinit(std.testing.allocator);
+        t.extra.deinit(std.testing.allocator);
+    }
+
+    fn add(t: *TestAir, tag: Air.Inst.Tag, data: Air.Inst.Data) !Air.Inst.Index {
+        const index: Air.Inst.Index = @enumFromInt(t.instructions.len);
+        try t.instructions.append(std.testing.allocator, .{ .tag = tag, .data = data });
+        return index;
+    }
+
+    fn addArg(t: *TestAir) !Air.Inst.Ref {
+        return (try t.add(.arg, .{ .arg = .{ .ty = .usize_type, .name = .none } })).toRef();
+    }
+
+    fn addCmp(t: *TestAir, tag: Air.Inst.Tag, lhs: Air.Inst.Ref, rhs: Air.Inst.Ref) !Air.Inst.Ref {
+        return (try t.add(tag, .{ .bin_op = .{ .lhs = lhs, .rhs = rhs } })).toRef();
+    }
+
+    fn addBody(t: *TestAir, body: []const Air.Inst.Index) !u32 {
+        if (t.extra.items.len == 0) try t.extra.append(std.testing.allocator, undefined);
+        const payload: u32 = @intCast(t.extra.items.len);
+        try t.extra.append(std.testing.allocator, @intCast(body.len));
+        try t.extra.appendSlice(std.testing.allocator, @ptrCast(body));
+        return payload;
+    }
+
+    fn addBlock(t: *TestAir, tag: Air.Inst.Tag, ty: Air.Inst.Ref, body: []const Air.Inst.Index) !Air.Inst.Index {
+        return t.add(tag, .{ .ty_pl = .{ .ty = ty, .payload = try t.addBody(body) } });
+    }
+
+    fn addCondBr(t: *TestAir, cond: Air.Inst.Ref, then_body: []const Air.Inst.Index, else_body: []const Air.Inst.Index) !Air.Inst.Index {
+        if (t.extra.items.len == 0) try t.extra.append(std.testing.allocator, undefined);
+        const payload: u32 = @intCast(t.extra.items.len);
+        try t.extra.appendSlice(std.testing.allocator, &.{ @intCast(then_body.len), @intCast(else_body.len) });
+        try t.extra.appendSlice(std.testing.allocator, @ptrCast(then_body));
+        try t.extra.appendSlice(std.testing.allocator, @ptrCast(else_body));
+        return t.add(.cond_br, .{ .pl_op = .{ .operand = cond, .payload = payload } });
+    }
+
+    /// The shape emitted by `Sema.addSafetyCheckExtra`.
+    fn addSafetyCheck(t: *TestAir, ok: Air.Inst.Ref) !Air.Inst.Index {
+        const block = try t.add(.block, undefined);
+        const br = try t.add(.br, .{ .br = .{ .block_inst = block, .operand = .void_value } });
+        const trap = try t.add(.trap, .{ .no_op = {} });
+        const cond_br = try t.addCondBr(ok, &.{br}, &.{trap});
+        t.instructions.items(.data)[@intFromEnum(block)] = .{ .ty_pl = .{
+            .ty = .void_type,
+            .payload = try t.addBody(&.{cond_br}),
+        } };
+        return block;
+    }
+
+    fn run(t: *TestAir, main_body: []const Air.Inst.Index) !Air {
+        const main_block = try t.addBody(main_body);
+        t.extra.items[@intFromEnum(Air.ExtraIndex.main_block)] = main_block;
+        const air: Air = .{ .instructions = t.instructions.slice(), .extra = t.extra.items };
+        try Optimize.run(std.testing.allocator, air);
+        return air;
+    }
+
+    fn isElided(air: Air, safety_check: Air.Inst.Index) bool {
+        const extra = air.extraData(Air.Block, air.instructions.items(.data)[@intFromEnum(safety_check)].ty_pl.payload);
+        const body: []const Air.Inst.Index = @ptrCast(air.extra[extra.end..][0..extra.data.body_len]);
+        return switch (air.instructions.items(.tag)[@intFromEnum(body[0])]) {
+            .br => true,
+            .cond_br => false,
+            else => unreachable,
+        };
+    }
+};
+
+test "repeated safety checks are removed" {
+    var t: TestAir = .{};
+    defer t.deinit();
+
+    const a = try t.addArg();
+    const b = try t.addArg();
+    const lt1 = try t.addCmp(.cmp_lt, a, b);
+    const check1 = try t.addSafetyCheck(lt1);
+    // Same operands, so the same value as `lt1`.
+    const lt2 = try t.addCmp(.cmp_lt, a, b);
+    const check2 = try t.addSafetyCheck(lt2);
+    // Different operands and a different comparison.
+    const lt3 = try t.addCmp(.cmp_lt, b, a);
+    const check3 = try t.addSafetyCheck(lt3);
+    const lte = try t.addCmp(.cmp_lte, a, b);
+    const check4 = try t.addSafetyCheck(lte);
+
+    const air = try t.run(&.{
+        a.toIndex().?,
+        b.toIndex().?,
+        lt1.toIndex().?,
+        check1,
+        lt2.toIndex().?,
+        check2,
+        lt3.toIndex().?,
+        check3,
+        lte.toIndex().?,
+        check4,
+    });
+    try std.testing.expect(!TestAir.isElided(air, check1));
+    try std.testing.expect(TestAir.isElided(air, check2));
+    try std.testing.expect(!TestAir.isElided(air, check3));
+    try std.testing.expect(!TestAir.isElided(air, check4));
+}
+
+test "safety checks are only removed where the condition is known" {
+    var t: TestAir = .{};
+    defer t.deinit();
+
+    const a = try t.addArg();
+    const b = try t.addArg();
+    const cond = try t.addCmp(.cmp_lt, a, b);
+
+    // Only the "then" body of a `cond_br` knows that its condition holds.
+    const then_lt = try t.addCmp(.cmp_lt, a, b);
+    const then_check = try t.addSafetyCheck(then_lt);
+    const else_lt = try t.addCmp(.cmp_lt, a, b);
+    const else_check = try t.addSafetyCheck(else_lt);
+    const cond_br = try t.addCondBr(
+        cond,
+        &.{ then_lt.toIndex().?, then_check },
+        &.{ else_lt.toIndex().?, else_check },
+    );
+
+    // A check inside a loop body says nothing about the code after the loop.
+    const loop_lt = try t.addCmp(.cmp_gt, a, b);
+    const loop_check = try t.addSafetyCheck(loop_lt);
+    const loop = try t.addBlock(.loop, .noreturn_type, &.{ loop_lt.toIndex().?, loop_check });
+    const after_loop_lt = try t.addCmp(.cmp_gt, a, b);
+    const after_loop_check = try t.addSafetyCheck(after_loop_lt);
+
+    // A check before a loop dominates the checks inside it.
+    const outer_lt = try t.addCmp(.cmp_neq, a, b);
+    const outer_check = try t.addSafetyCheck(outer_lt);
+    const inner_lt = try t.addCmp(.cmp_neq, a, b);
+    const inner_check = try t.addSafetyCheck(inner_lt);
+    const inner_loop = try t.addBlock(.loop, .noreturn_type, &.{ inner_lt.toIndex().?, inner_check });
+
+    const air = try t.run(&.{
+        a.toIndex().?,
+        b.toIndex().?,
+        cond.toIndex().?,
+        cond_br,
+        loop,
+        after_loop_lt.toIndex().?,
+        after_loop_check,
+        outer_lt.toIndex().?,
+        outer_check,
+        inner_loop,
+    });
+    try std.testing.expect(TestAir.isElided(air, then_check));
+    try std.testing.expect(!TestAir.isElided(air, else_check));
+    try std.testing.expect(!TestAir.isElided(air, loop_check));
+    try std.testing.expect(!TestAir.isElided(air, after_loop_check));
+    try std.testing.expect(!TestAir.isElided(air, outer_check));
+    try std.testing.expect(TestAir.isElided(air, inner_check));
+}
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const assert = std.debug.assert;
+const log = std.log.scoped(.air_optimize);
+
+const Air = @import("../Air.zig");
+const Optimize = @This();
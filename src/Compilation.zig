@@ -28,6 +28,8 @@ const libcxx = @import("libcxx.zig");
 const wasi_libc = @import("wasi_libc.zig");
 const fatal = @import("main.zig").fatal;
 const clangMain = @import("main.zig").clangMain;
+const clangInProcess = @import("main.zig").clangInProcess;
+const ClangInProcessResult = @import("main.zig").ClangInProcessResult;
 const Zcu = @import("Zcu.zig");
 const Sema = @import("Sema.zig");
 const InternPool = @import("InternPool.zig");
@@ -39,6 +41,7 @@ const Air = @import("Air.zig");
 const Builtin = @import("Builtin.zig");
 const LlvmObject = @import("codegen/llvm.zig").Object;
 const dev = @import("dev.zig");
+const TimeTrace = @import("TimeTrace.zig");
 
 pub const Config = @import("Compilation/Config.zig");
 
@@ -95,6 +98,15 @@ native_system_include_paths: []const []const u8,
 force_undefined_symbols: std.StringArrayHashMapUnmanaged(void),
 
 c_object_table: std.AutoArrayHashMapUnmanaged(*CObject, void) = .{},
+/// Shared by the cache manifests of all C objects and `@cImport`s, so that
+/// headers included by many of them are only stat'ed and hashed once per
+/// update. Cleared at the end of every update.
+c_file_memo: Cache.FileMemo = .{},
+/// Maps the names of C++20 modules declared by module interface units among
+/// the C source files to their precompiled interfaces, which are passed to
+/// every C++ compilation. Rebuilt whenever module interface units are
+/// compiled. Names are owned by gpa.
+cxx_module_files: std.StringArrayHashMapUnmanaged(CxxModuleFile) = .{},
 win32_resource_table: if (dev.env.supports(.win32_resource)) std.AutoArrayHashMapUnmanaged(*Win32Resource, void) else struct {
     pub fn keys(_: @This()) [0]void {
         return .{};
@@ -123,7 +135,7 @@ work_queues: [
 codegen_work: if (InternPool.single_threaded) void else struct {
     mutex: std.Thread.Mutex,
     cond: std.Thread.Condition,
-    queue: std.fifo.LinearFifo(CodegenJob, .Dynamic),
+    queue: std.fifo.LinearFifo(QueuedCodegenJob, .Dynamic),
     job_error: ?JobError,
     done: bool,
 },
@@ -173,6 +185,9 @@ misc_failures: std.AutoArrayHashMapUnmanaged(MiscTask, MiscError) = .{},
 /// This is `true` for `zig cc`, `zig c++`, and `zig translate-c`.
 clang_passthrough_mode: bool,
 clang_preprocessor_mode: ClangPreprocessorMode,
+/// Run clang on the thread pool rather than in a child process, where the
+/// command line allows it. Ignored in `clang_passthrough_mode`.
+clang_in_process: bool,
 /// Whether to print clang argvs to stdout.
 verbose_cc: bool,
 verbose_air: bool,
@@ -185,6 +200,9 @@ verbose_llvm_cpu_features: bool,
 verbose_link: bool,
 disable_c_depfile: bool,
 time_report: bool,
+/// Set with `-ftime-trace`. Allocated in `arena`.
+time_trace: ?*TimeTrace,
+time_trace_path: ?[]const u8,
 stack_report: bool,
 debug_compiler_runtime_libs: bool,
 debug_compile_errors: bool,
@@ -195,6 +213,13 @@ job_queued_fuzzer_lib: bool = false,
 job_queued_update_builtin_zig: bool,
 alloc_failure_occurred: bool = false,
 formatted_panics: bool = false,
+/// Run `Air.Optimize` on every function before codegen.
+air_optimize: bool = false,
+/// Have translate-c skip C function bodies; see `translate_c.Context`.
+cimport_skip_function_bodies: bool = false,
+/// Write static libraries as thin archives, which reference their members by
+/// path instead of containing copies of them.
+thin_archive: bool = false,
 last_update_was_cache_hit: bool = false,
 
 c_source_files: []const CSourceFile,
@@ -209,6 +234,8 @@ self_exe_path: ?[]const u8,
 zig_lib_directory: Directory,
 local_cache_directory: Directory,
 global_cache_directory: Directory,
+/// Passed on to the sub-compilations which build runtime libraries.
+runtime_store: ?RuntimeStore,
 libc_include_dir_list: []const []const u8,
 libc_framework_dir_list: []const []const u8,
 rc_includes: RcIncludes,
@@ -294,6 +321,20 @@ pub const Emit = struct {
 pub const default_stack_protector_buffer_size = target_util.default_stack_protector_buffer_size;
 pub const SemaError = Zcu.SemaError;
 
+/// A directory of prebuilt runtime libraries such as libc++, libunwind and
+/// the static parts of libc, which may be shared between cache directories
+/// and mounted read-only. It has the same layout as the "o" directory of a
+/// cache, except that the outputs are keyed by the manifest name of their
+/// sub-compilation, which covers the compiler version, target, CPU features
+/// and build options, rather than by the final digest, which is only known
+/// after building. Since the sources of these libraries are part of the Zig
+/// installation, this identifies the outputs as well.
+pub const RuntimeStore = struct {
+    directory: Directory,
+    /// Copy runtime libraries which had to be built into the store.
+    populate: bool,
+};
+
 pub const CRTFile = struct {
     lock: Cache.Lock,
     full_object_path: []const u8,
@@ -425,6 +466,12 @@ const CodegenJob = union(enum) {
     },
 };
 
+const QueuedCodegenJob = struct {
+    job: CodegenJob,
+    /// When this job was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
+};
+
 pub const CObject = struct {
     /// Relative to cwd. Owned by arena.
     src: CSourceFile,
@@ -996,6 +1043,11 @@ const CacheUse = union(CacheMode) {
         tmp_artifact_directory: ?Directory,
         /// Prevents other processes from clobbering files in the output directory.
         lock: ?Cache.Lock,
+        /// Where to look for a prebuilt output on a cache miss.
+        runtime_store: ?RuntimeStore,
+        /// Whether `bin_sub_path` is relative to `runtime_store` rather than
+        /// the local cache directory.
+        runtime_store_hit: bool = false,
 
         fn releaseLock(whole: *Whole) void {
             if (whole.lock) |*lock| {
@@ -1044,6 +1096,10 @@ pub const CreateOptions = struct {
     global_cache_directory: Directory,
     thread_pool: *ThreadPool,
     self_exe_path: ?[]const u8 = null,
+    runtime_store: ?RuntimeStore = null,
+    /// Look for the output in `runtime_store` before building it. Only
+    /// applies to `CacheMode.whole`.
+    use_runtime_store: bool = false,
 
     /// Options that have been resolved by calling `resolveDefaults`.
     config: Compilation.Config,
@@ -1106,10 +1162,15 @@ pub const CreateOptions = struct {
     want_compiler_rt: ?bool = null,
     want_lto: ?bool = null,
     formatted_panics: ?bool = null,
+    air_optimize: bool = false,
+    cimport_skip_function_bodies: bool = false,
+    thin_archive: bool = false,
     function_sections: bool = false,
     data_sections: bool = false,
     no_builtin: bool = false,
     time_report: bool = false,
+    /// Write a Chrome trace event JSON file to this path after each update.
+    time_trace: ?[]const u8 = null,
     stack_report: bool = false,
     link_eh_frame_hdr: bool = false,
     link_emit_relocs: bool = false,
@@ -1153,6 +1214,7 @@ pub const CreateOptions = struct {
     major_subsystem_version: ?u16 = null,
     minor_subsystem_version: ?u16 = null,
     clang_passthrough_mode: bool = false,
+    clang_in_process: bool = false,
     verbose_cc: bool = false,
     verbose_link: bool = false,
     verbose_air: bool = false,
@@ -1500,6 +1562,7 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
             .zig_lib_directory = options.zig_lib_directory,
             .local_cache_directory = options.local_cache_directory,
             .global_cache_directory = options.global_cache_directory,
+            .runtime_store = options.runtime_store,
             .emit_asm = options.emit_asm,
             .emit_llvm_ir = options.emit_llvm_ir,
             .emit_llvm_bc = options.emit_llvm_bc,
@@ -1507,7 +1570,7 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
             .codegen_work = if (InternPool.single_threaded) {} else .{
                 .mutex = .{},
                 .cond = .{},
-                .queue = std.fifo.LinearFifo(CodegenJob, .Dynamic).init(gpa),
+                .queue = std.fifo.LinearFifo(QueuedCodegenJob, .Dynamic).init(gpa),
                 .job_error = null,
                 .done = false,
             },
@@ -1526,6 +1589,7 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
             .thread_pool = options.thread_pool,
             .clang_passthrough_mode = options.clang_passthrough_mode,
             .clang_preprocessor_mode = options.clang_preprocessor_mode,
+            .clang_in_process = options.clang_in_process,
             .verbose_cc = options.verbose_cc,
             .verbose_air = options.verbose_air,
             .verbose_intern_pool = options.verbose_intern_pool,
@@ -1538,7 +1602,17 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
             .disable_c_depfile = options.disable_c_depfile,
             .reference_trace = options.reference_trace,
             .formatted_panics = formatted_panics,
+            .air_optimize = options.air_optimize,
+            .cimport_skip_function_bodies = options.cimport_skip_function_bodies,
+            .thin_archive = options.thin_archive,
             .time_report = options.time_report,
+            .time_trace = time_trace: {
+                if (options.time_trace == null) break :time_trace null;
+                const time_trace = try arena.create(TimeTrace);
+                time_trace.* = try TimeTrace.init(gpa);
+                break :time_trace time_trace;
+            },
+            .time_trace_path = options.time_trace,
             .stack_report = options.stack_report,
             .test_filters = options.test_filters,
             .test_name_prefix = options.test_name_prefix,
@@ -1656,6 +1730,7 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
                 hash.addOptionalBytes(options.test_name_prefix);
                 hash.add(options.skip_linker_dependencies);
                 hash.add(formatted_panics);
+                hash.add(options.air_optimize);
                 hash.add(options.emit_h != null);
                 hash.add(error_limit);
 
@@ -1730,6 +1805,7 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
                     .docs_sub_path = try prepareWholeEmitSubPath(arena, options.emit_docs),
                     .tmp_artifact_directory = null,
                     .lock = null,
+                    .runtime_store = if (options.use_runtime_store) options.runtime_store else null,
                 };
                 comp.cache_use = .{ .whole = whole };
             },
@@ -1940,11 +2016,15 @@ pub fn create(gpa: Allocator, arena: Allocator, options: CreateOptions) !*Compil
 
 pub fn destroy(comp: *Compilation) void {
     if (comp.bin_file) |lf| lf.destroy();
+    if (comp.time_trace) |time_trace| time_trace.deinit();
     if (comp.module) |zcu| zcu.deinit();
     comp.cache_use.deinit();
     for (comp.work_queues) |work_queue| work_queue.deinit();
     if (!InternPool.single_threaded) comp.codegen_work.queue.deinit();
     comp.c_object_work_queue.deinit();
+    comp.c_file_memo.deinit(comp.gpa);
+    comp.clearCxxModuleFiles();
+    comp.cxx_module_files.deinit(comp.gpa);
     comp.win32_resource_work_queue.deinit();
     comp.astgen_work_queue.deinit();
     comp.embed_file_work_queue.deinit();
@@ -2046,7 +2126,30 @@ pub fn hotCodeSwap(
     try lf.makeExecutable();
 }
 
+pub fn timeTraceNow(comp: *Compilation) TimeTrace.Timestamp {
+    const time_trace = comp.time_trace orelse return 0;
+    return time_trace.now();
+}
+
+/// Starts a `-ftime-trace` span on the calling thread; a no-op when tracing is disabled.
+/// `name` is copied and only needs to be valid for the duration of this call.
+pub fn timeTraceBegin(comp: *Compilation, category: TimeTrace.Category, name: []const u8) TimeTrace.Span {
+    return TimeTrace.begin(comp.time_trace, category, name);
+}
+
+/// The trace is rewritten after every update so that it is available even if
+/// the process later exits without destroying the Compilation. It only covers
+/// that update, since `update` resets it first.
+fn writeTimeTrace(comp: *Compilation) void {
+    const time_trace = comp.time_trace orelse return;
+    const path = comp.time_trace_path.?;
+    time_trace.writeFile(path) catch |err| {
+        log.warn("unable to write time trace to '{s}': {s}", .{ path, @errorName(err) });
+    };
+}
+
 fn cleanupAfterUpdate(comp: *Compilation) void {
+    comp.c_file_memo.clear(comp.gpa);
     switch (comp.cache_use) {
         .incremental => return,
         .whole => |whole| {
@@ -2080,11 +2183,14 @@ pub fn update(comp: *Compilation, main_progress_node: std.Progress.Node) !void {
 
     comp.clearMiscFailures();
     comp.last_update_was_cache_hit = false;
+    if (comp.time_trace) |time_trace| time_trace.reset();
 
     var man: Cache.Manifest = undefined;
     defer cleanupAfterUpdate(comp);
+    defer comp.writeTimeTrace();
 
     var tmp_dir_rand_int: u64 = undefined;
+    var runtime_store_key: [Cache.hex_digest_len]u8 = undefined;
 
     // If using the whole caching strategy, we check for *everything* up front, including
     // C source files.
@@ -2097,6 +2203,9 @@ pub fn update(comp: *Compilation, main_progress_node: std.Progress.Node) !void {
             man = comp.cache_parent.obtain();
             whole.cache_manifest = &man;
             try addNonIncrementalStuffToCacheManifest(comp, arena, &man);
+            whole.runtime_store_hit = false;
+            var runtime_store_hash = man.hash;
+            const input_file_count = man.files.count();
 
             const is_hit = man.hit() catch |err| {
                 const i = man.failed_file_index orelse return err;
@@ -2108,6 +2217,12 @@ pub fn update(comp: *Compilation, main_progress_node: std.Progress.Node) !void {
                     .{ prefix, pp.sub_path, @errorName(err) },
                 );
             };
+            // The runtime store outlives any one cache directory, so its key
+            // covers the contents of the input files rather than only their paths.
+            for (man.files.keys()[0..input_file_count]) |file| {
+                runtime_store_hash.addBytes(&file.bin_digest);
+            }
+            runtime_store_key = runtime_store_hash.final();
             if (is_hit) {
                 // In this case the cache hit contains the full set of file system inputs. Nice!
                 if (comp.file_system_inputs) |buf| try man.populateFileSystemInputs(buf);
@@ -2123,12 +2238,28 @@ pub fn update(comp: *Compilation, main_progress_node: std.Progress.Node) !void {
 
                 comp.wholeCacheModeSetBinFilePath(whole, &digest);
 
+                if (whole.runtime_store) |store| if (store.populate) {
+                    comp.addToRuntimeStore(whole, store, &runtime_store_key) catch |err| {
+                        log.warn("failed to add {s} to runtime store '{}': {s}", .{ comp.root_name, store.directory, @errorName(err) });
+                    };
+                };
+
                 assert(whole.lock == null);
                 whole.lock = man.toOwnedLock();
                 return;
             }
             log.debug("CacheMode.whole cache miss for {s}", .{comp.root_name});
 
+            if (whole.runtime_store) |store| {
+                if (comp.findInRuntimeStore(whole, store, &runtime_store_key)) {
+                    log.debug("CacheMode.whole runtime store hit for {s}", .{comp.root_name});
+                    comp.last_update_was_cache_hit = true;
+                    assert(whole.lock == null);
+                    whole.lock = man.toOwnedLock();
+                    return;
+                }
+            }
+
             // Compile the artifacts to a temporary directory.
             const tmp_artifact_directory = d: {
                 const s = std.fs.path.sep_str;
@@ -2398,6 +2529,12 @@ pub fn update(comp: *Compilation, main_progress_node: std.Progress.Node) !void {
                 comp.bin_file = null;
             }
 
+            if (whole.runtime_store) |store| if (store.populate) {
+                comp.addToRuntimeStore(whole, store, &runtime_store_key) catch |err| {
+                    log.warn("failed to add {s} to runtime store '{}': {s}", .{ comp.root_name, store.directory, @errorName(err) });
+                };
+            };
+
             assert(whole.lock == null);
             whole.lock = man.toOwnedLock();
         },
@@ -2540,6 +2677,42 @@ fn wholeCacheModeSetBinFilePath(
     }
 }
 
+/// On success, `whole.bin_sub_path` refers to the prebuilt output in `store`.
+fn findInRuntimeStore(
+    comp: *Compilation,
+    whole: *CacheUse.Whole,
+    store: RuntimeStore,
+    key: *const [Cache.hex_digest_len]u8,
+) bool {
+    // Runtime libraries have exactly one output.
+    const sub_path = whole.bin_sub_path orelse return false;
+    if (whole.implib_sub_path != null or whole.docs_sub_path != null) return false;
+    comp.wholeCacheModeSetBinFilePath(whole, key);
+    store.directory.handle.access(sub_path, .{}) catch return false;
+    whole.runtime_store_hit = true;
+    return true;
+}
+
+fn addToRuntimeStore(
+    comp: *Compilation,
+    whole: *CacheUse.Whole,
+    store: RuntimeStore,
+    key: *const [Cache.hex_digest_len]u8,
+) !void {
+    const sub_path = whole.bin_sub_path orelse return;
+    if (whole.implib_sub_path != null or whole.docs_sub_path != null) return;
+    const s = std.fs.path.sep_str;
+    const store_sub_path = try std.fmt.allocPrint(comp.gpa, "o" ++ s ++ "{s}" ++ s ++ "{s}", .{
+        key, std.fs.path.basename(sub_path),
+    });
+    defer comp.gpa.free(store_sub_path);
+    if (store.directory.handle.access(store_sub_path, .{})) |_| return else |_| {}
+    // Concurrent builds of the same library produce equivalent files, so
+    // whichever atomic rename comes last wins without harm.
+    try store.directory.handle.makePath(std.fs.path.dirname(store_sub_path).?);
+    try comp.local_cache_directory.handle.copyFile(sub_path, store.directory.handle, store_sub_path, .{});
+}
+
 fn prepareWholeEmitSubPath(arena: Allocator, opt_emit: ?EmitLoc) error{OutOfMemory}!?[]u8 {
     const emit = opt_emit orelse return null;
     if (emit.directory != null) return null;
@@ -2571,6 +2744,7 @@ fn addNonIncrementalStuffToCacheManifest(
         man.hash.addOptionalBytes(comp.test_name_prefix);
         man.hash.add(comp.skip_linker_dependencies);
         man.hash.add(comp.formatted_panics);
+        man.hash.add(comp.air_optimize);
         //man.hash.add(mod.emit_h != null);
         man.hash.add(mod.error_limit);
     } else {
@@ -2745,6 +2919,9 @@ pub fn emitLlvmObject(
     const sub_prog_node = prog_node.start("LLVM Emit Object", 0);
     defer sub_prog_node.end();
 
+    const time_trace_span = comp.timeTraceBegin(.llvm, "emit object");
+    defer time_trace_span.end();
+
     try llvm_object.emit(.{
         .pre_ir_path = comp.verbose_llvm_ir,
         .pre_bc_path = comp.verbose_llvm_bc,
@@ -3547,7 +3724,7 @@ fn performAllTheWorkInner(
 
     if (comp.docs_emit != null) {
         dev.check(.docs_emit);
-        comp.thread_pool.spawnWg(&work_queue_wait_group, workerDocsCopy, .{comp});
+        comp.thread_pool.spawnWg(&work_queue_wait_group, workerDocsCopy, .{ comp, comp.timeTraceNow() });
         work_queue_wait_group.spawnManager(workerDocsWasm, .{ comp, main_progress_node });
     }
 
@@ -3582,7 +3759,7 @@ fn performAllTheWorkInner(
                 const file = mod.builtin_file orelse continue;
 
                 comp.thread_pool.spawnWg(&astgen_wait_group, workerUpdateBuiltinZigFile, .{
-                    comp, mod, file,
+                    comp, mod, file, comp.timeTraceNow(),
                 });
             }
         }
@@ -3602,27 +3779,37 @@ fn performAllTheWorkInner(
                     const old_root_type = zcu.fileRootType(file_index);
                     const file = zcu.fileByIndex(file_index);
                     comp.thread_pool.spawnWgId(&astgen_wait_group, workerAstGenFile, .{
-                        comp, file, file_index, path_digest, old_root_type, zir_prog_node, &astgen_wait_group, .root,
+                        comp, file, file_index, path_digest, old_root_type, zir_prog_node, &astgen_wait_group, .root, comp.timeTraceNow(),
                     });
                 }
             }
 
             while (comp.embed_file_work_queue.readItem()) |embed_file| {
                 comp.thread_pool.spawnWg(&astgen_wait_group, workerCheckEmbedFile, .{
-                    comp, embed_file,
+                    comp, embed_file, comp.timeTraceNow(),
                 });
             }
         }
 
+        if (comp.hasQueuedCxxModuleInterface()) {
+            // C++ objects cannot be compiled until the module interfaces they
+            // import have been precompiled, which in turn happens in
+            // dependency order.
+            const c_objects = try comp.gpa.alloc(*CObject, comp.c_object_work_queue.count);
+            assert(comp.c_object_work_queue.read(c_objects) == c_objects.len);
+            work_queue_wait_group.spawnManager(workerBuildCxxModules, .{
+                comp, c_objects, main_progress_node, &work_queue_wait_group,
+            });
+        }
         while (comp.c_object_work_queue.readItem()) |c_object| {
             comp.thread_pool.spawnWg(&work_queue_wait_group, workerUpdateCObject, .{
-                comp, c_object, main_progress_node,
+                comp, c_object, main_progress_node, comp.timeTraceNow(),
             });
         }
 
         while (comp.win32_resource_work_queue.readItem()) |win32_resource| {
             comp.thread_pool.spawnWg(&work_queue_wait_group, workerUpdateWin32Resource, .{
-                comp, win32_resource, main_progress_node,
+                comp, win32_resource, main_progress_node, comp.timeTraceNow(),
             });
         }
     }
@@ -3950,7 +4137,7 @@ fn queueCodegenJob(comp: *Compilation, tid: usize, codegen_job: CodegenJob) !voi
     {
         comp.codegen_work.mutex.lock();
         defer comp.codegen_work.mutex.unlock();
-        try comp.codegen_work.queue.writeItem(codegen_job);
+        try comp.codegen_work.queue.writeItem(.{ .job = codegen_job, .queued = comp.timeTraceNow() });
     }
     comp.codegen_work.cond.signal();
 }
@@ -3960,11 +4147,16 @@ fn codegenThread(tid: usize, comp: *Compilation) void {
     defer comp.codegen_work.mutex.unlock();
 
     while (true) {
-        if (comp.codegen_work.queue.readItem()) |codegen_job| {
+        if (comp.codegen_work.queue.readItem()) |queued_job| {
             comp.codegen_work.mutex.unlock();
             defer comp.codegen_work.mutex.lock();
 
-            processOneCodegenJob(tid, comp, codegen_job) catch |job_error| {
+            if (comp.time_trace) |time_trace| time_trace.record(.queue, switch (queued_job.job) {
+                .nav => "codegen_nav",
+                .func => "codegen_func",
+            }, queued_job.queued, time_trace.now());
+
+            processOneCodegenJob(tid, comp, queued_job.job) catch |job_error| {
                 comp.codegen_work.job_error = job_error;
                 break;
             };
@@ -3997,7 +4189,13 @@ fn processOneCodegenJob(tid: usize, comp: *Compilation, codegen_job: CodegenJob)
     }
 }
 
-fn workerDocsCopy(comp: *Compilation) void {
+fn workerDocsCopy(
+    comp: *Compilation,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
+) void {
+    if (comp.time_trace) |time_trace| time_trace.record(.queue, "docs copy", queued, time_trace.now());
+
     docsCopyFallible(comp) catch |err| {
         return comp.lockAndSetMiscFailure(
             .docs_copy,
@@ -4245,6 +4443,7 @@ fn workerDocsWasmFallible(comp: *Compilation, prog_node: std.Progress.Node) anye
             .directory = null, // Put it in the cache directory.
             .basename = bin_basename,
         },
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
@@ -4295,23 +4494,32 @@ fn workerAstGenFile(
     prog_node: std.Progress.Node,
     wg: *WaitGroup,
     src: Zcu.AstGenSrc,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
 ) void {
+    if (comp.time_trace) |time_trace| time_trace.record(.queue, file.sub_file_path, queued, time_trace.now());
+
     const child_prog_node = prog_node.start(file.sub_file_path, 0);
     defer child_prog_node.end();
 
     const pt: Zcu.PerThread = .{ .zcu = comp.module.?, .tid = @enumFromInt(tid) };
-    pt.astGenFile(file, path_digest, old_root_type) catch |err| switch (err) {
-        error.AnalysisFail => return,
-        else => {
-            file.status = .retryable_failure;
-            pt.reportRetryableAstGenError(src, file_index, err) catch |oom| switch (oom) {
-                // Swallowing this error is OK because it's implied to be OOM when
-                // there is a missing `failed_files` error message.
-                error.OutOfMemory => {},
-            };
-            return;
-        },
-    };
+    {
+        const time_trace_span = comp.timeTraceBegin(.astgen, file.sub_file_path);
+        defer time_trace_span.end();
+
+        pt.astGenFile(file, path_digest, old_root_type) catch |err| switch (err) {
+            error.AnalysisFail => return,
+            else => {
+                file.status = .retryable_failure;
+                pt.reportRetryableAstGenError(src, file_index, err) catch |oom| switch (oom) {
+                    // Swallowing this error is OK because it's implied to be OOM when
+                    // there is a missing `failed_files` error message.
+                    error.OutOfMemory => {},
+                };
+                return;
+            },
+        };
+    }
 
     // Pre-emptively look for `@import` paths and queue them up.
     // If we experience an error preemptively fetching the
@@ -4358,7 +4566,7 @@ fn workerAstGenFile(
                     .import_tok = item.data.token,
                 } };
                 comp.thread_pool.spawnWgId(wg, workerAstGenFile, .{
-                    comp, import_result.file, import_result.file_index, imported_path_digest, imported_root_type, prog_node, wg, sub_src,
+                    comp, import_result.file, import_result.file_index, imported_path_digest, imported_root_type, prog_node, wg, sub_src, comp.timeTraceNow(),
                 });
             }
         }
@@ -4369,7 +4577,11 @@ fn workerUpdateBuiltinZigFile(
     comp: *Compilation,
     mod: *Package.Module,
     file: *Zcu.File,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
 ) void {
+    if (comp.time_trace) |time_trace| time_trace.record(.queue, file.sub_file_path, queued, time_trace.now());
+
     Builtin.populateFile(comp, mod, file) catch |err| {
         comp.mutex.lock();
         defer comp.mutex.unlock();
@@ -4380,7 +4592,17 @@ fn workerUpdateBuiltinZigFile(
     };
 }
 
-fn workerCheckEmbedFile(comp: *Compilation, embed_file: *Zcu.EmbedFile) void {
+fn workerCheckEmbedFile(
+    comp: *Compilation,
+    embed_file: *Zcu.EmbedFile,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
+) void {
+    if (comp.time_trace) |time_trace| {
+        const ip = &comp.module.?.intern_pool;
+        time_trace.record(.queue, embed_file.sub_file_path.toSlice(ip), queued, time_trace.now());
+    }
+
     comp.detectEmbedFileUpdate(embed_file) catch |err| {
         comp.reportRetryableEmbedFileError(embed_file, err) catch |oom| switch (oom) {
             // Swallowing this error is OK because it's implied to be OOM when
@@ -4410,10 +4632,11 @@ fn detectEmbedFileUpdate(comp: *Compilation, embed_file: *Zcu.EmbedFile) !void {
 }
 
 pub fn obtainCObjectCacheManifest(
-    comp: *const Compilation,
+    comp: *Compilation,
     owner_mod: *Package.Module,
 ) Cache.Manifest {
     var man = comp.cache_parent.obtain();
+    man.file_memo = &comp.c_file_memo;
 
     // Only things that need to be added on top of the base hash, and only things
     // that apply both to @cImport and compiling C objects. No linking stuff here!
@@ -4468,6 +4691,7 @@ pub fn cImport(comp: *Compilation, c_src: []const u8, owner_mod: *Package.Module
     man.hash.add(@as(u16, 0xb945)); // Random number to distinguish translate-c from compiling C objects
     man.hash.addBytes(c_src);
     man.hash.add(comp.config.c_frontend);
+    man.hash.add(comp.cimport_skip_function_bodies);
 
     // If the previous invocation resulted in clang errors, we will see a hit
     // here with 0 files in the manifest, in which case it is actually a miss.
@@ -4496,9 +4720,21 @@ pub fn cImport(comp: *Compilation, c_src: []const u8, owner_mod: *Package.Module
         });
         const out_dep_path = try std.fmt.allocPrint(arena, "{s}.d", .{out_h_path});
 
-        try zig_cache_tmp_dir.writeFile(.{ .sub_path = cimport_basename, .data = c_src });
+        const pch = comp.cImportPch(arena, c_src, owner_mod) catch |err| switch (err) {
+            error.OutOfMemory => return error.OutOfMemory,
+            else => pch: {
+                log.warn("unable to precompile C import preamble: {s}", .{@errorName(err)});
+                break :pch null;
+            },
+        };
+
+        try zig_cache_tmp_dir.writeFile(.{
+            .sub_path = cimport_basename,
+            .data = if (pch) |p| p.main_src else c_src,
+        });
         if (comp.verbose_cimport) {
             log.info("C import source: {s}", .{out_h_path});
+            if (pch) |p| log.info("C import precompiled preamble: {s}", .{p.path});
         }
 
         var argv = std.ArrayList([]const u8).init(comp.gpa);
@@ -4508,10 +4744,14 @@ pub fn cImport(comp: *Compilation, c_src: []const u8, owner_mod: *Package.Module
         try comp.addTranslateCCArgs(arena, &argv, .c, out_dep_path, owner_mod);
 
         try argv.append(out_h_path);
+        // Must stay last so that it can be dropped if the preamble turns out
+        // to be unusable.
+        if (pch) |p| try argv.appendSlice(&.{ "-include-pch", p.path });
 
         if (comp.verbose_cc) {
             dump_argv(argv.items);
         }
+        var used_pch = pch != null;
         var tree = switch (comp.config.c_frontend) {
             .aro => tree: {
                 if (true) @panic("TODO");
@@ -4532,22 +4772,36 @@ pub fn cImport(comp: *Compilation, c_src: []const u8, owner_mod: *Package.Module
                 const c_headers_dir_path_z = try comp.zig_lib_directory.joinZ(arena, &[_][]const u8{"include"});
                 var errors = std.zig.ErrorBundle.empty;
                 errdefer errors.deinit(comp.gpa);
-                break :tree translate_c.translate(
-                    comp.gpa,
-                    new_argv.ptr,
-                    new_argv.ptr + new_argv.len,
-                    &errors,
-                    c_headers_dir_path_z,
-                ) catch |err| switch (err) {
-                    error.OutOfMemory => return error.OutOfMemory,
-                    error.SemanticAnalyzeFail => {
-                        return CImportResult{
-                            .out_zig_path = "",
-                            .cache_hit = actual_hit,
-                            .errors = errors,
-                        };
-                    },
-                };
+                while (true) {
+                    const argv_len = if (pch != null and !used_pch) new_argv.len - 2 else new_argv.len;
+                    break :tree translate_c.translate(
+                        comp.gpa,
+                        new_argv.ptr,
+                        new_argv.ptr + argv_len,
+                        &errors,
+                        c_headers_dir_path_z,
+                        comp.cimport_skip_function_bodies,
+                    ) catch |err| switch (err) {
+                        error.OutOfMemory => return error.OutOfMemory,
+                        error.SemanticAnalyzeFail => {
+                            if (used_pch) {
+                                // The precompiled preamble may have been built with
+                                // incompatible options or be out of date; errors in
+                                // the source itself will be reported by the retry.
+                                errors.deinit(comp.gpa);
+                                errors = std.zig.ErrorBundle.empty;
+                                used_pch = false;
+                                try zig_cache_tmp_dir.writeFile(.{ .sub_path = cimport_basename, .data = c_src });
+                                continue;
+                            }
+                            return CImportResult{
+                                .out_zig_path = "",
+                                .cache_hit = actual_hit,
+                                .errors = errors,
+                            };
+                        },
+                    };
+                }
             },
         };
         defer tree.deinit(comp.gpa);
@@ -4566,6 +4820,21 @@ pub fn cImport(comp: *Compilation, c_src: []const u8, owner_mod: *Package.Module
             },
             .incremental => {},
         }
+        if (used_pch) {
+            // Headers read from the precompiled header are missing from the
+            // dependency file above.
+            var pch_dir = try comp.local_cache_directory.handle.openDir(pch.?.dir_sub_path, .{});
+            defer pch_dir.close();
+            try man.addDepFilePost(pch_dir, cimport_pch_dep_basename);
+            switch (comp.cache_use) {
+                .whole => |whole| if (whole.cache_manifest) |whole_cache_manifest| {
+                    whole.cache_manifest_mutex.lock();
+                    defer whole.cache_manifest_mutex.unlock();
+                    try whole_cache_manifest.addDepFilePost(pch_dir, cimport_pch_dep_basename);
+                },
+                .incremental => {},
+            }
+        }
 
         const digest = man.final();
         const o_sub_path = try std.fs.path.join(arena, &[_][]const u8{ "o", &digest });
@@ -4606,11 +4875,610 @@ pub fn cImport(comp: *Compilation, c_src: []const u8, owner_mod: *Package.Module
     };
 }
 
+const cimport_pch_basename = "cimport.pch";
+const cimport_pch_dep_basename = cimport_pch_basename ++ ".d";
+
+const CImportPch = struct {
+    /// Path to the precompiled header.
+    path: []const u8,
+    /// Directory containing the precompiled header and its dependency file,
+    /// relative to the local cache directory.
+    dir_sub_path: []const u8,
+    /// The C import source with the precompiled preamble replaced by blank
+    /// lines, so that line numbers in diagnostics are unchanged.
+    main_src: []const u8,
+};
+
+/// Returns the length of the leading run of `#include`, `#define` and `#undef`
+/// lines in `c_src`, up to and including the last `#include` in that run. This
+/// is the part of a `@cImport` which is worth precompiling: it is usually
+/// where all of the time goes, and it is often the same across `@cImport`s.
+fn cImportPreambleLen(c_src: []const u8) usize {
+    var preamble_len: usize = 0;
+    var line_start: usize = 0;
+    while (line_start < c_src.len) {
+        const line_end = if (mem.indexOfScalarPos(u8, c_src, line_start, '\n')) |i| i + 1 else c_src.len;
+        const line = mem.trim(u8, c_src[line_start..line_end], " \t\r\n");
+        // A line continuation would pull the next line into the preamble.
+        if (mem.endsWith(u8, line, "\\")) break;
+        if (mem.startsWith(u8, line, "#include")) {
+            preamble_len = line_end;
+        } else if (line.len != 0 and
+            !mem.startsWith(u8, line, "#define") and
+            !mem.startsWith(u8, line, "#undef"))
+        {
+            break;
+        }
+        line_start = line_end;
+    }
+    return preamble_len;
+}
+
+/// Precompiles the preamble of `c_src` into a header which is cached like a C
+/// object, so that other `@cImport`s with the same preamble, in this build or
+/// a later one, do not need to parse those headers again. Returns `null` if
+/// `c_src` has no preamble or it could not be precompiled.
+fn cImportPch(comp: *Compilation, arena: Allocator, c_src: []const u8, owner_mod: *Package.Module) !?CImportPch {
+    if (!build_options.have_llvm or comp.config.c_frontend != .clang) return null;
+    const self_exe_path = comp.self_exe_path orelse return null;
+    const preamble_len = cImportPreambleLen(c_src);
+    if (preamble_len == 0) return null;
+    const preamble = c_src[0..preamble_len];
+
+    var man = comp.obtainCObjectCacheManifest(owner_mod);
+    defer man.deinit();
+
+    man.hash.add(@as(u16, 0x3c7e)); // Random number to distinguish C import preambles from other C cache entries
+    man.hash.addBytes(preamble);
+
+    // As in `cImport`, a failed build leaves a manifest without files behind.
+    const prev_hash_state = man.hash.peekBin();
+    const actual_hit = hit: {
+        _ = try man.hit();
+        if (man.files.entries.len == 0) {
+            man.unhit(prev_hash_state, 0);
+            break :hit false;
+        }
+        break :hit true;
+    };
+    const pch_digest = if (!actual_hit) digest: {
+        // The precompiled header records the path of the preamble and checks
+        // it whenever it is loaded, so the preamble lives in a directory named
+        // after its contents and is never rewritten once it exists.
+        const preamble_digest = Cache.HashHelper.oneShot(preamble);
+        const preamble_dir_sub_path = try std.fs.path.join(arena, &.{ "o", &preamble_digest });
+        const preamble_basename = "cimport_preamble.h";
+        {
+            var preamble_dir = try comp.local_cache_directory.handle.makeOpenPath(preamble_dir_sub_path, .{});
+            defer preamble_dir.close();
+            preamble_dir.access(preamble_basename, .{}) catch |err| switch (err) {
+                error.FileNotFound => {
+                    var af = try preamble_dir.atomicFile(preamble_basename, .{});
+                    defer af.deinit();
+                    try af.file.writeAll(preamble);
+                    try af.finish();
+                },
+                else => |e| return e,
+            };
+        }
+        const preamble_path = try comp.local_cache_directory.join(arena, &.{ preamble_dir_sub_path, preamble_basename });
+
+        // The precompiled header is built in a temporary directory and renamed
+        // to `o/<digest>` once its dependencies are known, so that a cached
+        // precompiled header is never modified while another `@cImport` or
+        // another process may be reading it.
+        const tmp_dir_sub_path = try std.fs.path.join(arena, &.{
+            "tmp", &std.fmt.hex(std.crypto.random.int(u64)),
+        });
+        // After a successful rename there is nothing left to delete.
+        defer comp.local_cache_directory.handle.deleteTree(tmp_dir_sub_path) catch {};
+        {
+            var tmp_dir = try comp.local_cache_directory.handle.makeOpenPath(tmp_dir_sub_path, .{});
+            defer tmp_dir.close();
+            const tmp_pch_path = try comp.local_cache_directory.join(arena, &.{ tmp_dir_sub_path, cimport_pch_basename });
+            const dep_path = try comp.local_cache_directory.join(arena, &.{ tmp_dir_sub_path, cimport_pch_dep_basename });
+
+            var argv = std.ArrayList([]const u8).init(arena);
+            try argv.appendSlice(&.{ self_exe_path, "clang" });
+            // Must match `addTranslateCCArgs` apart from the language, or clang
+            // will refuse to load the precompiled header.
+            try argv.appendSlice(&.{ "-x", "c-header" });
+            try comp.addCCArgs(arena, &argv, .c, dep_path, owner_mod);
+            try argv.appendSlice(&.{ "-Xclang", "-detailed-preprocessing-record" });
+            try argv.appendSlice(&.{ "-Xclang", "-emit-pch", "-o", tmp_pch_path, preamble_path });
+
+            if (comp.verbose_cc) {
+                dump_argv(argv.items);
+            }
+
+            const in_process_result = if (comp.clang_in_process)
+                try clangInProcess(arena, argv.items)
+            else
+                null;
+            const result: ClangInProcessResult = if (in_process_result) |result| result else result: {
+                if (!std.process.can_spawn) return null;
+                const run_result = try std.process.Child.run(.{
+                    .allocator = arena,
+                    .argv = argv.items,
+                    .max_output_bytes = std.math.maxInt(u32),
+                });
+                break :result .{
+                    .exit_code = switch (run_result.term) {
+                        .Exited => |code| code,
+                        else => 1,
+                    },
+                    .stderr = run_result.stderr,
+                };
+            };
+            if (result.exit_code != 0) {
+                // Errors in these headers are reported by translate-c, which
+                // parses them again without the precompiled header.
+                log.debug("failed to precompile C import preamble: {s}", .{result.stderr});
+                return null;
+            }
+
+            try man.addDepFilePost(tmp_dir, cimport_pch_dep_basename);
+        }
+
+        const digest = man.final();
+        const o_sub_path = try std.fs.path.join(arena, &.{ "o", &digest });
+        try renameTmpIntoCache(comp.local_cache_directory, tmp_dir_sub_path, o_sub_path);
+        man.writeManifest() catch |err| {
+            log.warn("failed to write cache manifest for C import preamble: {s}", .{@errorName(err)});
+        };
+        break :digest digest;
+    } else man.final();
+
+    const dir_sub_path = try std.fs.path.join(arena, &.{ "o", &pch_digest });
+    const pch_path = try comp.local_cache_directory.join(arena, &.{ dir_sub_path, cimport_pch_basename });
+
+    const rest = c_src[preamble_len..];
+    const main_src = try arena.alloc(u8, mem.count(u8, preamble, "\n") + rest.len);
+    @memset(main_src[0 .. main_src.len - rest.len], '\n');
+    @memcpy(main_src[main_src.len - rest.len ..], rest);
+
+    return .{
+        .path = pch_path,
+        .dir_sub_path = dir_sub_path,
+        .main_src = main_src,
+    };
+}
+
+pub const CxxModuleDecls = struct {
+    /// The module declared by `export module`, including the partition, if any.
+    name: ?[]const u8 = null,
+    /// Named modules imported by the unit, with partitions qualified by the
+    /// name of the primary module.
+    imports: std.ArrayListUnmanaged([]const u8) = .{},
+};
+
+/// Finds the module declaration and the named module imports of a C++20
+/// module unit. This is a lexical scan of lines starting with `export`,
+/// `module` or `import` outside of comments, without preprocessing, which
+/// covers module units written the conventional way. Header unit imports are
+/// ignored.
+pub fn scanCxxModuleDecls(arena: Allocator, source: []const u8) Allocator.Error!CxxModuleDecls {
+    var decls: CxxModuleDecls = .{};
+    // The primary module name of the unit, which partition imports refer to.
+    var primary: ?[]const u8 = null;
+
+    var in_block_comment = false;
+    var lines = mem.splitScalar(u8, source, '\n');
+    while (lines.next()) |raw_line| {
+        var line = raw_line;
+        if (in_block_comment) {
+            const end = mem.indexOf(u8, line, "*/") orelse continue;
+            line = line[end + 2 ..];
+            in_block_comment = false;
+        }
+        line = mem.trim(u8, line, " \t\r");
+        if (mem.indexOf(u8, line, "/*")) |start| {
+            in_block_comment = mem.indexOfPos(u8, line, start + 2, "*/") == null;
+            if (start == 0) continue;
+        }
+
+        var rest = line;
+        const exported = eatCxxKeyword(&rest, "export");
+        if (eatCxxKeyword(&rest, "module")) {
+            const name = cxxModuleName(rest) orelse continue;
+            if (name.len == 0 or name[0] == ':') continue;
+            const colon = mem.indexOfScalar(u8, name, ':');
+            primary = try arena.dupe(u8, name[0 .. colon orelse name.len]);
+            if (exported) {
+                decls.name = try arena.dupe(u8, name);
+            } else if (colon == null) {
+                // A module implementation unit implicitly imports its interface.
+                try decls.imports.append(arena, primary.?);
+            }
+        } else if (eatCxxKeyword(&rest, "import")) {
+            const name = cxxModuleName(rest) orelse continue;
+            if (name.len == 0) continue;
+            if (name[0] == ':') {
+                const primary_name = primary orelse continue;
+                try decls.imports.append(arena, try std.fmt.allocPrint(arena, "{s}{s}", .{ primary_name, name }));
+            } else {
+                try decls.imports.append(arena, try arena.dupe(u8, name));
+            }
+        }
+    }
+    return decls;
+}
+
+fn eatCxxKeyword(rest: *[]const u8, keyword: []const u8) bool {
+    if (!mem.startsWith(u8, rest.*, keyword)) return false;
+    if (rest.len > keyword.len) switch (rest.*[keyword.len]) {
+        'a'...'z', 'A'...'Z', '0'...'9', '_' => return false,
+        else => {},
+    };
+    rest.* = mem.trimLeft(u8, rest.*[keyword.len..], " \t");
+    return true;
+}
+
+/// Returns the module name in front of the `;` ending a module declaration
+/// or import, or null if `rest` does not look like one.
+fn cxxModuleName(rest: []const u8) ?[]const u8 {
+    const end = mem.indexOfScalar(u8, rest, ';') orelse return null;
+    const name = mem.trim(u8, rest[0..end], " \t");
+    for (name) |c| switch (c) {
+        'a'...'z', 'A'...'Z', '0'...'9', '_', '.', ':' => {},
+        else => return null,
+    };
+    return name;
+}
+
+pub const CxxModuleFile = struct {
+    /// Path of the precompiled module interface. Owned by gpa.
+    path: []const u8,
+    /// The module interface unit it was built from.
+    c_object: *CObject,
+    /// Names of the modules imported by the interface unit, each followed by
+    /// a zero byte. Owned by gpa.
+    imports: []const u8,
+};
+
+fn clearCxxModuleFiles(comp: *Compilation) void {
+    for (comp.cxx_module_files.keys(), comp.cxx_module_files.values()) |name, module_file| {
+        comp.gpa.free(name);
+        comp.gpa.free(module_file.path);
+        comp.gpa.free(module_file.imports);
+    }
+    comp.cxx_module_files.clearRetainingCapacity();
+}
+
+/// Returns the names of the modules in `cxx_module_files` which `imports`
+/// refer to, directly or through the imports of other modules, each once.
+/// Other imports, such as `std`, are left to clang.
+fn cxxModuleDeps(comp: *const Compilation, arena: Allocator, imports: []const []const u8) Allocator.Error![]const []const u8 {
+    var seen: std.StringArrayHashMapUnmanaged(void) = .{};
+    for (imports) |import_name| try seen.put(arena, import_name, {});
+    var deps = std.ArrayList([]const u8).init(arena);
+    var i: usize = 0;
+    while (i < seen.count()) : (i += 1) {
+        const name = seen.keys()[i];
+        const module_file = comp.cxx_module_files.get(name) orelse continue;
+        try deps.append(name);
+        var it = mem.tokenizeScalar(u8, module_file.imports, 0);
+        while (it.next()) |import_name| try seen.put(arena, import_name, {});
+    }
+    return deps.items;
+}
+
+fn hasQueuedCxxModuleInterface(comp: *const Compilation) bool {
+    // A single module interface unit has nothing which could import it.
+    if (comp.c_object_work_queue.count < 2) return false;
+    for (0..comp.c_object_work_queue.count) |i| {
+        if (hasCxxModuleInterfaceExt(comp.c_object_work_queue.peekItem(i).src.src_path)) return true;
+    }
+    return false;
+}
+
+/// Precompiles the module interface units among `c_objects` in dependency
+/// order, then queues all of `c_objects` except interface units which failed.
+/// Takes ownership of `c_objects`.
+fn workerBuildCxxModules(
+    comp: *Compilation,
+    c_objects: []*CObject,
+    progress_node: std.Progress.Node,
+    wait_group: *WaitGroup,
+) void {
+    defer comp.gpa.free(c_objects);
+    const failed = comp.buildCxxModules(c_objects, progress_node) catch |err| switch (err) {
+        error.OutOfMemory => failed: {
+            comp.setAllocFailure();
+            break :failed &.{};
+        },
+    };
+    defer comp.gpa.free(failed);
+    for (c_objects) |c_object| {
+        if (mem.indexOfScalar(*CObject, failed, c_object) != null) continue;
+        comp.thread_pool.spawnWg(wait_group, workerUpdateCObject, .{ comp, c_object, progress_node, comp.timeTraceNow() });
+    }
+}
+
+const CxxModuleUnit = struct {
+    c_object: *CObject,
+    decls: CxxModuleDecls,
+    state: enum { pending, building, built, failed } = .pending,
+    /// Set by a successful build until moved into `cxx_module_files`.
+    /// Owned by gpa.
+    module_file_path: ?[]const u8 = null,
+};
+
+/// Returns the interface units which failed, allocated with gpa.
+fn buildCxxModules(comp: *Compilation, c_objects: []const *CObject, progress_node: std.Progress.Node) error{OutOfMemory}![]*CObject {
+    const gpa = comp.gpa;
+    var arena_allocator = std.heap.ArenaAllocator.init(gpa);
+    defer arena_allocator.deinit();
+    const arena = arena_allocator.allocator();
+
+    comp.clearCxxModuleFiles();
+
+    var failed = std.ArrayList(*CObject).init(gpa);
+    defer failed.deinit();
+    var units = std.ArrayList(CxxModuleUnit).init(arena);
+    defer for (units.items) |unit| if (unit.module_file_path) |path| gpa.free(path);
+    var units_by_name = std.StringHashMap(usize).init(arena);
+    for (c_objects) |c_object| {
+        if (!hasCxxModuleInterfaceExt(c_object.src.src_path)) continue;
+        if (c_object.clearStatus(gpa)) {
+            comp.mutex.lock();
+            defer comp.mutex.unlock();
+            _ = comp.failed_c_objects.swapRemove(c_object);
+        }
+        const source = std.fs.cwd().readFileAlloc(arena, c_object.src.src_path, std.math.maxInt(u32)) catch |err| {
+            try comp.reportRetryableCObjectError(c_object, err);
+            try failed.append(c_object);
+            continue;
+        };
+        const decls = try scanCxxModuleDecls(arena, source);
+        const name = decls.name orelse {
+            // Not an interface after all; compile it like any other unit.
+            continue;
+        };
+        const gop = try units_by_name.getOrPut(name);
+        if (gop.found_existing) {
+            switch (comp.failCObj(c_object, "module '{s}' is also declared by '{s}'", .{
+                name, units.items[gop.value_ptr.*].c_object.src.src_path,
+            })) {
+                error.AnalysisFail => {},
+                else => |e| return e,
+            }
+            try failed.append(c_object);
+            continue;
+        }
+        gop.value_ptr.* = units.items.len;
+        try units.append(.{ .c_object = c_object, .decls = decls });
+    }
+
+    const bmi_prog_node = progress_node.start("Precompile C++ Modules", units.items.len);
+    defer bmi_prog_node.end();
+
+    // Build every unit whose imports are available, one wave at a time.
+    // Imports of modules not built here, such as `std`, are left to clang.
+    while (true) {
+        var wait_group: WaitGroup = .{};
+        var progress = false;
+        for (units.items) |*unit| {
+            if (unit.state != .pending) continue;
+            const ready = for (unit.decls.imports.items) |import_name| {
+                const dep = &units.items[units_by_name.get(import_name) orelse continue];
+                switch (dep.state) {
+                    .built => {},
+                    .pending, .building => break false,
+                    .failed => {
+                        unit.state = .failed;
+                        progress = true;
+                        switch (comp.failCObj(unit.c_object, "imported module '{s}' failed to build", .{import_name})) {
+                            error.AnalysisFail => {},
+                            else => |e| return e,
+                        }
+                        break false;
+                    },
+                }
+            } else true;
+            if (!ready) continue;
+            unit.state = .building;
+            progress = true;
+            comp.thread_pool.spawnWg(&wait_group, workerBuildCxxModule, .{ comp, unit, bmi_prog_node, comp.timeTraceNow() });
+        }
+        if (!progress) break;
+        comp.thread_pool.waitAndWork(&wait_group);
+
+        for (units.items) |*unit| {
+            const path = unit.module_file_path orelse continue;
+            try comp.cxx_module_files.ensureUnusedCapacity(gpa, 1);
+            const name = try gpa.dupe(u8, unit.decls.name.?);
+            errdefer gpa.free(name);
+            var imports = std.ArrayList(u8).init(gpa);
+            errdefer imports.deinit();
+            for (unit.decls.imports.items) |import_name| {
+                try imports.ensureUnusedCapacity(import_name.len + 1);
+                imports.appendSliceAssumeCapacity(import_name);
+                imports.appendAssumeCapacity(0);
+            }
+            comp.cxx_module_files.putAssumeCapacityNoClobber(name, .{
+                .path = path,
+                .c_object = unit.c_object,
+                .imports = try imports.toOwnedSlice(),
+            });
+            unit.module_file_path = null;
+        }
+    }
+
+    for (units.items) |*unit| switch (unit.state) {
+        .pending => {
+            switch (comp.failCObj(unit.c_object, "module '{s}' is part of an import cycle", .{unit.decls.name.?})) {
+                error.AnalysisFail => {},
+                else => |e| return e,
+            }
+            try failed.append(unit.c_object);
+        },
+        .failed => try failed.append(unit.c_object),
+        .building => unreachable,
+        .built => {},
+    };
+    return failed.toOwnedSlice();
+}
+
+fn workerBuildCxxModule(
+    comp: *Compilation,
+    unit: *CxxModuleUnit,
+    progress_node: std.Progress.Node,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
+) void {
+    if (comp.time_trace) |time_trace| time_trace.record(.queue, unit.c_object.src.src_path, queued, time_trace.now());
+
+    unit.module_file_path = comp.buildCxxModule(unit.c_object, unit.decls, progress_node) catch |err| {
+        unit.state = .failed;
+        switch (err) {
+            error.AnalysisFail => {},
+            else => comp.reportRetryableCObjectError(unit.c_object, err) catch {},
+        }
+        return;
+    };
+    unit.state = .built;
+}
+
+/// Precompiles a module interface unit into a binary module interface (BMI),
+/// which is cached like a C object. The modules in `cxx_module_files` which it
+/// imports, directly or indirectly, are available to it. Returns the path of
+/// the BMI, owned by gpa.
+fn buildCxxModule(
+    comp: *Compilation,
+    c_object: *CObject,
+    decls: CxxModuleDecls,
+    progress_node: std.Progress.Node,
+) ![]const u8 {
+    if (!build_options.have_llvm) {
+        return comp.failCObj(c_object, "clang not available: compiler built without LLVM extensions", .{});
+    }
+    const self_exe_path = comp.self_exe_path orelse
+        return comp.failCObj(c_object, "clang compilation disabled", .{});
+    const name = decls.name.?;
+
+    const child_progress_node = progress_node.start(name, 0);
+    defer child_progress_node.end();
+
+    var arena_allocator = std.heap.ArenaAllocator.init(comp.gpa);
+    defer arena_allocator.deinit();
+    const arena = arena_allocator.allocator();
+
+    var man = comp.obtainCObjectCacheManifest(c_object.src.owner);
+    defer man.deinit();
+
+    man.hash.add(@as(u16, 0x6d64)); // Random number to distinguish BMIs from other C cache entries
+    try cache_helpers.hashCSource(&man, c_object.src);
+    // BMIs are rewritten in place when their sources change, so the contents
+    // of the imported interfaces are inputs.
+    const cxx_module_deps = try comp.cxxModuleDeps(arena, decls.imports.items);
+    try comp.addCxxModuleFiles(&man, cxx_module_deps);
+
+    // As in `cImportPch`, the output location depends only on the inputs, so
+    // that the path handed to importers is known before checking for a hit.
+    const bmi_digest = man.hash.peek();
+    const dir_sub_path = try std.fs.path.join(arena, &.{ "o", &bmi_digest });
+    var bmi_dir = try comp.local_cache_directory.handle.makeOpenPath(dir_sub_path, .{});
+    defer bmi_dir.close();
+    const bmi_basename = try std.fmt.allocPrint(arena, "{s}.pcm", .{name});
+    mem.replaceScalar(u8, bmi_basename, ':', '-');
+    const bmi_path = try comp.local_cache_directory.join(comp.gpa, &.{ dir_sub_path, bmi_basename });
+    errdefer comp.gpa.free(bmi_path);
+
+    // Unlike in `cImportPch`, the interface source and the imported BMIs are
+    // inputs before the check, so `hit` alone tells whether they changed.
+    if (try man.hit()) return bmi_path;
+
+    const dep_basename = "module.d";
+    const diag_basename = "module.diag";
+    const dep_path = try comp.local_cache_directory.join(arena, &.{ dir_sub_path, dep_basename });
+    const diag_path = try comp.local_cache_directory.join(arena, &.{ dir_sub_path, diag_basename });
+    defer bmi_dir.deleteFile(diag_basename) catch {};
+
+    var argv = std.ArrayList([]const u8).init(arena);
+    try argv.appendSlice(&.{ self_exe_path, "clang", c_object.src.src_path });
+    try comp.addCCArgs(arena, &argv, .cpp, dep_path, c_object.src.owner);
+    try argv.appendSlice(c_object.src.extra_flags);
+    try argv.appendSlice(c_object.src.cache_exempt_flags);
+    try comp.addCxxModuleFileArgs(arena, &argv, cxx_module_deps);
+    try argv.appendSlice(&.{ "--serialize-diagnostics", diag_path, "--precompile", "-o", bmi_path });
+
+    if (comp.verbose_cc) {
+        dump_argv(argv.items);
+    }
+
+    const in_process_result = if (comp.clang_in_process)
+        try clangInProcess(arena, argv.items)
+    else
+        null;
+    const result: ClangInProcessResult = if (in_process_result) |result| result else result: {
+        if (!std.process.can_spawn) {
+            return comp.failCObj(c_object, "unable to precompile module '{s}': cannot spawn clang", .{name});
+        }
+        const run_result = std.process.Child.run(.{
+            .allocator = arena,
+            .argv = argv.items,
+            .max_output_bytes = std.math.maxInt(u32),
+        }) catch |err| {
+            return comp.failCObj(c_object, "unable to spawn {s}: {s}", .{ argv.items[0], @errorName(err) });
+        };
+        break :result .{
+            .exit_code = switch (run_result.term) {
+                .Exited => |code| code,
+                else => 1,
+            },
+            .stderr = run_result.stderr,
+        };
+    };
+    if (result.exit_code != 0) {
+        const bundle = CObject.Diag.Bundle.parse(comp.gpa, diag_path) catch |err| {
+            log.err("{}: failed to parse clang diagnostics: {s}", .{ err, result.stderr });
+            return comp.failCObj(c_object, "clang exited with code {d}", .{result.exit_code});
+        };
+        return comp.failCObjWithOwnedDiagBundle(c_object, bundle);
+    }
+
+    try man.addDepFilePost(bmi_dir, dep_basename);
+    _ = man.final();
+    man.writeManifest() catch |err| {
+        log.warn("failed to write cache manifest when precompiling '{s}': {s}", .{ c_object.src.src_path, @errorName(err) });
+    };
+    return bmi_path;
+}
+
+/// Adds the precompiled module interfaces of `names`, as returned by
+/// `cxxModuleDeps`, as inputs of `man`.
+fn addCxxModuleFiles(comp: *Compilation, man: *Cache.Manifest, names: []const []const u8) !void {
+    for (names) |name| {
+        man.hash.addBytes(name);
+        _ = try man.addFile(comp.cxx_module_files.get(name).?.path, null);
+    }
+}
+
+/// Makes the precompiled module interfaces of `names`, as returned by
+/// `cxxModuleDeps`, available to clang.
+fn addCxxModuleFileArgs(
+    comp: *Compilation,
+    arena: Allocator,
+    argv: *std.ArrayList([]const u8),
+    names: []const []const u8,
+) Allocator.Error!void {
+    try argv.ensureUnusedCapacity(names.len);
+    for (names) |name| {
+        const module_file = comp.cxx_module_files.get(name).?;
+        argv.appendAssumeCapacity(try std.fmt.allocPrint(arena, "-fmodule-file={s}={s}", .{ name, module_file.path }));
+    }
+}
+
 fn workerUpdateCObject(
     comp: *Compilation,
     c_object: *CObject,
     progress_node: std.Progress.Node,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
 ) void {
+    if (comp.time_trace) |time_trace| time_trace.record(.queue, c_object.src.src_path, queued, time_trace.now());
+
     comp.updateCObject(c_object, progress_node) catch |err| switch (err) {
         error.AnalysisFail => return,
         else => {
@@ -4627,7 +5495,14 @@ fn workerUpdateWin32Resource(
     comp: *Compilation,
     win32_resource: *Win32Resource,
     progress_node: std.Progress.Node,
+    /// When this task was queued, for `-ftime-trace`.
+    queued: TimeTrace.Timestamp,
 ) void {
+    if (comp.time_trace) |time_trace| time_trace.record(.queue, switch (win32_resource.src) {
+        .rc => |rc_src| rc_src.src_path,
+        .manifest => |manifest_path| manifest_path,
+    }, queued, time_trace.now());
+
     comp.updateWin32Resource(win32_resource, progress_node) catch |err| switch (err) {
         error.AnalysisFail => return,
         else => {
@@ -4769,6 +5644,20 @@ fn updateCObject(comp: *Compilation, c_object: *CObject, c_obj_prog_node: std.Pr
     defer arena_allocator.deinit();
     const arena = arena_allocator.allocator();
 
+    const ext = c_object.src.ext orelse classifyFileExt(c_object.src.src_path);
+    const uses_cxx_modules = switch (ext) {
+        .cpp, .mm => true,
+        else => false,
+    };
+    // Only the modules which the unit imports, directly or indirectly, are
+    // inputs, so that editing another module interface does not rebuild it.
+    const cxx_module_deps: []const []const u8 = if (uses_cxx_modules and comp.cxx_module_files.count() > 0) deps: {
+        const source = try std.fs.cwd().readFileAlloc(arena, c_object.src.src_path, std.math.maxInt(u32));
+        const decls = try scanCxxModuleDecls(arena, source);
+        break :deps try comp.cxxModuleDeps(arena, decls.imports.items);
+    } else &.{};
+    try comp.addCxxModuleFiles(&man, cxx_module_deps);
+
     const c_source_basename = std.fs.path.basename(c_object.src.src_path);
 
     const child_progress_node = c_obj_prog_node.start(c_source_basename, 0);
@@ -4804,7 +5693,6 @@ fn updateCObject(comp: *Compilation, c_object: *CObject, c_obj_prog_node: std.Pr
             break :e o_ext;
         };
         const o_basename = try std.fmt.allocPrint(arena, "{s}{s}", .{ o_basename_noext, out_ext });
-        const ext = c_object.src.ext orelse classifyFileExt(c_object.src.src_path);
 
         try argv.appendSlice(&[_][]const u8{ self_exe_path, "clang" });
         // if "ext" is explicit, add "-x <lang>". Otherwise let clang do its thing.
@@ -4837,6 +5725,7 @@ fn updateCObject(comp: *Compilation, c_object: *CObject, c_obj_prog_node: std.Pr
             try comp.addCCArgs(arena, &argv, ext, null, c_object.src.owner);
             try argv.appendSlice(c_object.src.extra_flags);
             try argv.appendSlice(c_object.src.cache_exempt_flags);
+            try comp.addCxxModuleFileArgs(arena, &argv, cxx_module_deps);
 
             const out_obj_path = if (comp.bin_file) |lf|
                 try lf.emit.directory.join(arena, &.{lf.emit.sub_path})
@@ -4885,6 +5774,7 @@ fn updateCObject(comp: *Compilation, c_object: *CObject, c_obj_prog_node: std.Pr
         try comp.addCCArgs(arena, &argv, ext, out_dep_path, c_object.src.owner);
         try argv.appendSlice(c_object.src.extra_flags);
         try argv.appendSlice(c_object.src.cache_exempt_flags);
+        try comp.addCxxModuleFileArgs(arena, &argv, cxx_module_deps);
 
         try argv.ensureUnusedCapacity(6);
         switch (comp.clang_preprocessor_mode) {
@@ -4916,7 +5806,22 @@ fn updateCObject(comp: *Compilation, c_object: *CObject, c_obj_prog_node: std.Pr
         defer if (out_dep_path) |dep_file_path| zig_cache_tmp_dir.deleteFile(std.fs.path.basename(dep_file_path)) catch |err| {
             log.warn("failed to delete '{s}': {s}", .{ dep_file_path, @errorName(err) });
         };
-        if (std.process.can_spawn) {
+        const in_process_result = if (comp.clang_in_process and !comp.clang_passthrough_mode)
+            try clangInProcess(arena, argv.items)
+        else
+            null;
+        if (in_process_result) |result| {
+            if (result.exit_code != 0) if (out_diag_path) |diag_file_path| {
+                const bundle = CObject.Diag.Bundle.parse(comp.gpa, diag_file_path) catch |err| {
+                    log.err("{}: failed to parse clang diagnostics: {s}", .{ err, result.stderr });
+                    return comp.failCObj(c_object, "clang exited with code {d}", .{result.exit_code});
+                };
+                return comp.failCObjWithOwnedDiagBundle(c_object, bundle);
+            } else {
+                log.err("clang failed with stderr: {s}", .{result.stderr});
+                return comp.failCObj(c_object, "clang exited with code {d}", .{result.exit_code});
+            };
+        } else if (std.process.can_spawn) {
             var child = std.process.Child.init(argv.items, arena);
             if (comp.clang_passthrough_mode) {
                 child.stdin_behavior = .Inherit;
@@ -5491,8 +6396,10 @@ pub fn addCCArgs(
                 "-nostdinc",
                 "-fno-spell-checking",
             });
-            if (comp.config.lto) {
-                try argv.append("-flto");
+            switch (comp.config.lto) {
+                .none => {},
+                .full => try argv.append("-flto=full"),
+                .thin => try argv.append("-flto=thin"),
             }
 
             if (ext == .mm) {
@@ -6021,7 +6928,16 @@ pub fn hasCppExt(filename: []const u8) bool {
         mem.endsWith(u8, filename, ".cpp") or
         mem.endsWith(u8, filename, ".cxx") or
         mem.endsWith(u8, filename, ".c++") or
-        mem.endsWith(u8, filename, ".stub");
+        mem.endsWith(u8, filename, ".stub") or
+        hasCxxModuleInterfaceExt(filename);
+}
+
+/// C++20 module interface units, which clang compiles as C++.
+pub fn hasCxxModuleInterfaceExt(filename: []const u8) bool {
+    return mem.endsWith(u8, filename, ".cppm") or
+        mem.endsWith(u8, filename, ".ccm") or
+        mem.endsWith(u8, filename, ".cxxm") or
+        mem.endsWith(u8, filename, ".c++m");
 }
 
 pub fn hasObjCExt(filename: []const u8) bool {
@@ -6103,6 +7019,7 @@ pub fn classifyFileExt(filename: []const u8) FileExt {
 
 test "classifyFileExt" {
     try std.testing.expectEqual(FileExt.cpp, classifyFileExt("foo.cc"));
+    try std.testing.expectEqual(FileExt.cpp, classifyFileExt("foo.cppm"));
     try std.testing.expectEqual(FileExt.m, classifyFileExt("foo.m"));
     try std.testing.expectEqual(FileExt.mm, classifyFileExt("foo.mm"));
     try std.testing.expectEqual(FileExt.unknown, classifyFileExt("foo.nim"));
@@ -6114,6 +7031,16 @@ test "classifyFileExt" {
     try std.testing.expectEqual(FileExt.zig, classifyFileExt("foo.zig"));
 }
 
+test "cImportPreambleLen" {
+    try std.testing.expectEqual(0, cImportPreambleLen(""));
+    try std.testing.expectEqual(0, cImportPreambleLen("#define FOO 1\n"));
+    try std.testing.expectEqual(19, cImportPreambleLen("#include <stdio.h>\n"));
+    try std.testing.expectEqual(18, cImportPreambleLen("#include <stdio.h>"));
+    try std.testing.expectEqual(34, cImportPreambleLen("#define FOO 1\n\n#include <stdio.h>\n#define BAR 2\n"));
+    try std.testing.expectEqual(19, cImportPreambleLen("#include <stdio.h>\nint x;\n#include <stdlib.h>\n"));
+    try std.testing.expectEqual(0, cImportPreambleLen("#define FOO \\\n 1\n#include <stdio.h>\n"));
+}
+
 pub fn get_libc_crt_file(comp: *Compilation, arena: Allocator, basename: []const u8) ![]const u8 {
     if (comp.wantBuildGLibCFromSource() or
         comp.wantBuildMuslFromSource() or
@@ -6435,6 +7362,7 @@ fn buildOutputFromZig(
         .data_sections = true,
         .no_builtin = true,
         .emit_h = null,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
@@ -6490,7 +7418,7 @@ pub fn build_crt_file(
         .link_libc = false,
         .lto = switch (output_mode) {
             .Lib => comp.config.lto,
-            .Obj, .Exe => false,
+            .Obj, .Exe => .none,
         },
     });
     const root_mod = try Package.Module.create(arena, .{
@@ -6532,6 +7460,8 @@ pub fn build_crt_file(
         .zig_lib_directory = comp.zig_lib_directory,
         .self_exe_path = comp.self_exe_path,
         .cache_mode = .whole,
+        .runtime_store = comp.runtime_store,
+        .use_runtime_store = true,
         .config = config,
         .root_mod = root_mod,
         .root_name = root_name,
@@ -6543,6 +7473,7 @@ pub fn build_crt_file(
         },
         .emit_h = null,
         .c_source_files = c_source_files,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
@@ -6564,10 +7495,10 @@ pub fn build_crt_file(
 }
 
 pub fn toCrtFile(comp: *Compilation) Allocator.Error!CRTFile {
+    const whole = comp.cache_use.whole;
+    const directory = if (whole.runtime_store_hit) whole.runtime_store.?.directory else comp.local_cache_directory;
     return .{
-        .full_object_path = try comp.local_cache_directory.join(comp.gpa, &.{
-            comp.cache_use.whole.bin_sub_path.?,
-        }),
+        .full_object_path = try directory.join(comp.gpa, &.{whole.bin_sub_path.?}),
         .lock = comp.cache_use.whole.moveLock(),
     };
 }
@@ -6617,3 +7548,32 @@ pub fn compilerRtOptMode(comp: Compilation) std.builtin.OptimizeMode {
 pub fn compilerRtStrip(comp: Compilation) bool {
     return comp.root_mod.strip;
 }
+
+test scanCxxModuleDecls {
+    var arena_allocator = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena_allocator.deinit();
+    const arena = arena_allocator.allocator();
+
+    const decls = try scanCxxModuleDecls(arena,
+        \\module;
+        \\#include <cstdio>
+        \\export module math.core:vec;
+        \\// import commented.out;
+        \\/* import also.commented;
+        \\   import still.commented; */
+        \\import :scalar;
+        \\export import util;
+        \\import <vector>;
+        \\importer x;
+        \\
+    );
+    try std.testing.expectEqualStrings("math.core:vec", decls.name.?);
+    try std.testing.expectEqual(2, decls.imports.items.len);
+    try std.testing.expectEqualStrings("math.core:scalar", decls.imports.items[0]);
+    try std.testing.expectEqualStrings("util", decls.imports.items[1]);
+
+    const impl = try scanCxxModuleDecls(arena, "module math.core;\nimport util;\n");
+    try std.testing.expect(impl.name == null);
+    try std.testing.expectEqual(2, impl.imports.items.len);
+    try std.testing.expectEqualStrings("math.core", impl.imports.items[0]);
+}
@@ -94,7 +94,13 @@ pub const JobQueue = struct {
     all_fetches: std.ArrayListUnmanaged(*Fetch) = .{},
 
     http_client: *std.http.Client,
+    /// Runs the CPU-bound work of unpacking and hashing packages.
     thread_pool: *ThreadPool,
+    /// Runs `workerRun` for each package. Fetching a package is mostly
+    /// waiting on the network, so this pool may have more threads than
+    /// `thread_pool`, which bounds how many packages are downloaded at once
+    /// independently of the number of CPUs. `null` means `thread_pool`.
+    fetch_thread_pool: ?*ThreadPool = null,
     wait_group: WaitGroup = .{},
     global_cache: Cache.Directory,
     /// If true then, no fetching occurs, and:
@@ -119,6 +125,13 @@ pub const JobQueue = struct {
     pub const Table = std.AutoArrayHashMapUnmanaged(Manifest.MultiHashHexDigest, *Fetch);
     pub const UnlazySet = std.AutoArrayHashMapUnmanaged(Manifest.MultiHashHexDigest, void);
 
+    /// A reasonable number of threads for `fetch_thread_pool`.
+    pub const max_concurrent_fetches = 16;
+
+    pub fn fetchThreadPool(jq: *JobQueue) *ThreadPool {
+        return jq.fetch_thread_pool orelse jq.thread_pool;
+    }
+
     pub fn deinit(jq: *JobQueue) void {
         if (jq.all_fetches.items.len == 0) return;
         const gpa = jq.all_fetches.items[0].arena.child_allocator;
@@ -499,7 +512,7 @@ fn runResource(
         // Empty directories have already been omitted by `unpackResource`.
         // Compute the package hash based on the remaining files in the temporary
         // directory.
-        f.actual_hash = try computeHash(f, pkg_path, filter);
+        f.actual_hash = try computeHash(f, pkg_path, filter, &unpack_result);
 
         break :blk if (unpack_result.root_dir.len > 0)
             try fs.path.join(arena, &.{ tmp_dir_sub_path, unpack_result.root_dir })
@@ -726,7 +739,7 @@ fn queueJobsForDeps(f: *Fetch) RunError!void {
     };
 
     // Now it's time to give tasks to the thread pool.
-    const thread_pool = f.job_queue.thread_pool;
+    const thread_pool = f.job_queue.fetchThreadPool();
 
     for (new_fetches, prog_names) |*new_fetch, prog_name| {
         thread_pool.spawnWg(&f.job_queue.wait_group, workerRun, .{ new_fetch, prog_name });
@@ -1171,17 +1184,13 @@ fn unpackTarball(f: *Fetch, out_dir: fs.Dir, reader: anytype) RunError!UnpackRes
 
     var diagnostics: std.tar.Diagnostics = .{ .allocator = arena };
 
-    std.tar.pipeToFileSystem(out_dir, reader, .{
-        .diagnostics = &diagnostics,
-        .strip_components = 0,
-        .mode_mode = .ignore,
-        .exclude_empty_directories = true,
-    }) catch |err| return f.fail(f.location_tok, try eb.printString(
+    var res: UnpackResult = .{};
+    pipeTarballAndHash(f, out_dir, reader, &diagnostics, &res) catch |err| return f.fail(f.location_tok, try eb.printString(
         "unable to unpack tarball to temporary directory: {s}",
         .{@errorName(err)},
     ));
 
-    var res: UnpackResult = .{ .root_dir = diagnostics.root_dir };
+    res.root_dir = diagnostics.root_dir;
     if (diagnostics.errors.items.len > 0) {
         try res.allocErrors(arena, diagnostics.errors.items.len, "unable to unpack tarball");
         for (diagnostics.errors.items) |item| {
@@ -1196,6 +1205,209 @@ fn unpackTarball(f: *Fetch, out_dir: fs.Dir, reader: anytype) RunError!UnpackRes
     return res;
 }
 
+/// Files up to this size are read into memory and handed to a thread pool
+/// worker to be written and hashed while the tarball continues to be
+/// decompressed. Larger files are written and hashed as they stream out.
+const max_buffered_file_size = 1024 * 1024;
+/// Limits the memory held by buffered files which the thread pool has not
+/// written yet. Once it is reached, files are streamed like large ones until
+/// the workers catch up, rather than blocking the unpacking thread, which is
+/// itself a thread pool worker.
+const max_buffered_bytes_in_flight = 16 * max_buffered_file_size;
+
+/// Equivalent to `std.tar.pipeToFileSystem` with `mode_mode = .ignore` and
+/// `exclude_empty_directories = true`, except that file contents are hashed as
+/// they are written, so that `computeHash` does not have to read them back.
+fn pipeTarballAndHash(
+    f: *Fetch,
+    out_dir: fs.Dir,
+    reader: anytype,
+    diagnostics: *std.tar.Diagnostics,
+    res: *UnpackResult,
+) !void {
+    const arena = f.arena.allocator();
+    const gpa = f.arena.child_allocator;
+    const thread_pool = f.job_queue.thread_pool;
+
+    var unpacked_files = std.ArrayList(*UnpackedFile).init(gpa);
+    defer unpacked_files.deinit();
+
+    // Only this thread adds to it, and the workers subtract what they finish.
+    var bytes_in_flight = std.atomic.Value(usize).init(0);
+
+    {
+        var wait_group: WaitGroup = .{};
+        // `pipeTarballAndHash` is called from a worker thread so there must
+        // not be any waiting without working or a deadlock could occur.
+        defer thread_pool.waitAndWork(&wait_group);
+
+        var file_name_buffer: [fs.max_path_bytes]u8 = undefined;
+        var link_name_buffer: [fs.max_path_bytes]u8 = undefined;
+        var iter = std.tar.iterator(reader, .{
+            .file_name_buffer = &file_name_buffer,
+            .link_name_buffer = &link_name_buffer,
+            .diagnostics = diagnostics,
+        });
+
+        // The package root directory is only known for certain once every
+        // entry has been seen, but the hash of each file includes its path
+        // relative to the package root. Guess based on the first entry; if
+        // the guess turns out to be wrong, `computeHash` hashes the files
+        // again from disk.
+        var hashed_root_dir: ?[]const u8 = null;
+
+        while (try iter.next()) |file| {
+            if (file.name.len == 0) continue;
+            try diagnostics.findRoot(file.name);
+            const root_dir = hashed_root_dir orelse r: {
+                const top_level = std.mem.indexOfScalar(u8, std.mem.trim(u8, file.name, "/"), '/') == null;
+                const guess = if (file.kind != .directory and top_level)
+                    ""
+                else
+                    try arena.dupe(u8, diagnostics.root_dir);
+                hashed_root_dir = guess;
+                res.hashed_root_dir = guess;
+                break :r guess;
+            };
+
+            switch (file.kind) {
+                .directory => {}, // omit empty directories
+                .file => {
+                    const fs_path = try arena.dupe(u8, file.name);
+                    if (fs.path.sep != canonical_sep) std.mem.replaceScalar(u8, fs_path, canonical_sep, fs.path.sep);
+                    const unpacked_file = try arena.create(UnpackedFile);
+                    unpacked_file.* = .{
+                        .hashed_file = .{
+                            .fs_path = fs_path,
+                            .normalized_path = try normalizePathAlloc(arena, stripRoot(fs_path, root_dir)),
+                            .kind = .file,
+                            .hash = undefined, // to be populated by the worker
+                            .failure = undefined, // to be populated by the worker
+                        },
+                        .file_name = try arena.dupe(u8, file.name),
+                    };
+                    try unpacked_files.append(unpacked_file);
+
+                    if (file.size <= max_buffered_file_size and
+                        bytes_in_flight.load(.monotonic) + file.size <= max_buffered_bytes_in_flight)
+                    {
+                        const contents = try gpa.alloc(u8, @intCast(file.size));
+                        errdefer gpa.free(contents);
+                        try file.reader().readNoEof(contents);
+                        _ = bytes_in_flight.fetchAdd(contents.len, .monotonic);
+                        thread_pool.spawnWg(&wait_group, workerUnpackFile, .{ out_dir, unpacked_file, contents, gpa, &bytes_in_flight });
+                    } else {
+                        var out_file = createUnpackedFile(out_dir, fs_path) catch |err| {
+                            unpacked_file.create_failure = err;
+                            continue;
+                        };
+                        defer out_file.close();
+                        var hasher = fileHasher(unpacked_file.hashed_file.normalized_path);
+                        var file_header: FileHeader = .{};
+                        var buf: [8000]u8 = undefined;
+                        var remaining = file.size;
+                        while (remaining > 0) {
+                            const chunk = buf[0..@min(buf.len, remaining)];
+                            try file.reader().readNoEof(chunk);
+                            hasher.update(chunk);
+                            file_header.update(chunk);
+                            try out_file.writeAll(chunk);
+                            remaining -= chunk.len;
+                        }
+                        if (file_header.isExecutable()) try setExecutable(out_file);
+                        hasher.final(&unpacked_file.hashed_file.hash);
+                        unpacked_file.hashed_file.failure = {};
+                    }
+                },
+                .sym_link => {
+                    const link_name = file.link_name;
+                    createUnpackedSymLink(out_dir, link_name, file.name) catch |err| {
+                        try diagnostics.errors.append(diagnostics.allocator, .{ .unable_to_create_sym_link = .{
+                            .code = err,
+                            .file_name = try diagnostics.allocator.dupe(u8, file.name),
+                            .link_name = try diagnostics.allocator.dupe(u8, link_name),
+                        } });
+                    };
+                },
+            }
+        }
+    }
+
+    for (unpacked_files.items) |unpacked_file| {
+        if (unpacked_file.create_failure) |err| {
+            try diagnostics.errors.append(diagnostics.allocator, .{ .unable_to_create_file = .{
+                .code = err,
+                .file_name = unpacked_file.file_name,
+            } });
+            continue;
+        }
+        try unpacked_file.hashed_file.failure;
+        try res.hashed_files.put(arena, unpacked_file.hashed_file.fs_path, &unpacked_file.hashed_file);
+    }
+}
+
+/// A file from a tarball which is written to disk and hashed in one pass.
+const UnpackedFile = struct {
+    hashed_file: HashedFile,
+    /// Name of the file as it appears in the tarball.
+    file_name: []const u8,
+    /// Failing to create a file is reported like the other unpacking
+    /// diagnostics, since it may turn out to be excluded from the package.
+    create_failure: ?anyerror = null,
+};
+
+fn workerUnpackFile(
+    dir: fs.Dir,
+    unpacked_file: *UnpackedFile,
+    contents: []u8,
+    gpa: Allocator,
+    bytes_in_flight: *std.atomic.Value(usize),
+) void {
+    defer {
+        _ = bytes_in_flight.fetchSub(contents.len, .monotonic);
+        gpa.free(contents);
+    }
+    const hashed_file = &unpacked_file.hashed_file;
+    var file = createUnpackedFile(dir, hashed_file.fs_path) catch |err| {
+        unpacked_file.create_failure = err;
+        return;
+    };
+    defer file.close();
+    hashed_file.failure = writeAndHashFile(file, hashed_file, contents);
+}
+
+fn writeAndHashFile(file: fs.File, hashed_file: *HashedFile, contents: []const u8) HashedFile.Error!void {
+    var hasher = fileHasher(hashed_file.normalized_path);
+    hasher.update(contents);
+    try file.writeAll(contents);
+    var file_header: FileHeader = .{};
+    file_header.update(contents);
+    if (file_header.isExecutable()) try setExecutable(file);
+    hasher.final(&hashed_file.hash);
+}
+
+fn createUnpackedFile(dir: fs.Dir, fs_path: []const u8) !fs.File {
+    return dir.createFile(fs_path, .{ .exclusive = true }) catch |err| switch (err) {
+        error.FileNotFound => {
+            const dir_name = fs.path.dirname(fs_path) orelse return err;
+            try dir.makePath(dir_name);
+            return dir.createFile(fs_path, .{ .exclusive = true });
+        },
+        else => |e| return e,
+    };
+}
+
+fn createUnpackedSymLink(dir: fs.Dir, link_name: []const u8, file_name: []const u8) !void {
+    dir.symLink(link_name, file_name, .{}) catch |err| switch (err) {
+        error.FileNotFound => {
+            const dir_name = fs.path.dirname(file_name) orelse return err;
+            try dir.makePath(dir_name);
+            return dir.symLink(link_name, file_name, .{});
+        },
+        else => |e| return e,
+    };
+}
+
 fn unzip(f: *Fetch, out_dir: fs.Dir, reader: anytype) RunError!UnpackResult {
     // We write the entire contents to a file first because zip files
     // must be processed back to front and they could be too large to
@@ -1421,6 +1633,7 @@ fn computeHash(
     f: *Fetch,
     pkg_path: Cache.Path,
     filter: Filter,
+    unpack_result: *const UnpackResult,
 ) RunError!Manifest.Digest {
     // All the path name strings need to be in memory for sorting.
     const arena = f.arena.allocator();
@@ -1493,6 +1706,13 @@ fn computeHash(
             if (std.mem.eql(u8, entry_pkg_path, Package.build_zig_basename))
                 f.has_build_zig = true;
 
+            if (kind == .file) {
+                if (unpack_result.hashedFile(entry.path)) |hashed_file| {
+                    try all_files.append(hashed_file);
+                    continue;
+                }
+            }
+
             const fs_path = try arena.dupe(u8, entry.path);
             const hashed_file = try arena.create(HashedFile);
             hashed_file.* = .{
@@ -1602,17 +1822,25 @@ fn workerDeleteFile(dir: fs.Dir, deleted_file: *DeletedFile) void {
     deleted_file.failure = deleteFileFallible(dir, deleted_file);
 }
 
+/// Returns a hasher primed with everything that goes into the hash of a
+/// regular file before its contents.
+fn fileHasher(normalized_path: []const u8) Manifest.Hash {
+    var hasher = Manifest.Hash.init(.{});
+    hasher.update(normalized_path);
+    // Hard-coded false executable bit: https://github.com/ziglang/zig/issues/17463
+    hasher.update(&.{ 0, 0 });
+    return hasher;
+}
+
 fn hashFileFallible(dir: fs.Dir, hashed_file: *HashedFile) HashedFile.Error!void {
     var buf: [8000]u8 = undefined;
     var hasher = Manifest.Hash.init(.{});
-    hasher.update(hashed_file.normalized_path);
 
     switch (hashed_file.kind) {
         .file => {
             var file = try dir.openFile(hashed_file.fs_path, .{});
             defer file.close();
-            // Hard-coded false executable bit: https://github.com/ziglang/zig/issues/17463
-            hasher.update(&.{ 0, 0 });
+            hasher = fileHasher(hashed_file.normalized_path);
             var file_header: FileHeader = .{};
             while (true) {
                 const bytes_read = try file.read(&buf);
@@ -1625,6 +1853,7 @@ fn hashFileFallible(dir: fs.Dir, hashed_file: *HashedFile) HashedFile.Error!void
             }
         },
         .link => {
+            hasher.update(hashed_file.normalized_path);
             const link_name = try dir.readLink(hashed_file.fs_path, &buf);
             if (fs.path.sep != canonical_sep) {
                 // Package hashes are intended to be consistent across
@@ -1671,6 +1900,7 @@ const HashedFile = struct {
         fs.File.ReadError ||
         fs.File.StatError ||
         fs.File.ChmodError ||
+        fs.File.WriteError ||
         fs.Dir.ReadLinkError;
 
     const Kind = enum { file, link };
@@ -1830,6 +2060,12 @@ const UnpackResult = struct {
     // sub-directory indicated by the named path.
     root_dir: []const u8 = "",
 
+    // Files which were hashed while being unpacked, keyed by file system path
+    // relative to the unpack directory. Their hashes are only valid if the
+    // package root turned out to be `hashed_root_dir`.
+    hashed_files: std.StringHashMapUnmanaged(*HashedFile) = .{},
+    hashed_root_dir: []const u8 = "",
+
     const Error = union(enum) {
         unable_to_create_sym_link: struct {
             code: anyerror,
@@ -1855,6 +2091,12 @@ const UnpackResult = struct {
         }
     };
 
+    /// Returns the file at `fs_path` if it was already hashed while unpacking.
+    fn hashedFile(self: *const UnpackResult, fs_path: []const u8) ?*HashedFile {
+        if (!std.mem.eql(u8, self.hashed_root_dir, self.root_dir)) return null;
+        return self.hashed_files.get(fs_path);
+    }
+
     fn allocErrors(self: *UnpackResult, arena: std.mem.Allocator, n: usize, root_error_message: []const u8) !void {
         self.root_error_message = try arena.dupe(u8, root_error_message);
         self.errors = try arena.alloc(UnpackResult.Error, n);
@@ -2221,6 +2463,59 @@ test "set executable bit based on file content" {
     // -rwxrwxr-x 1    17 Apr   script_with_shebang_without_exec_bit
 }
 
+test "hashing while unpacking matches hashing from disk" {
+    const gpa = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    // Small files are buffered and written by the thread pool, the large one
+    // is streamed, and the script gets its executable bit from its contents.
+    const big_contents = try gpa.alloc(u8, max_buffered_file_size + max_buffered_file_size / 2);
+    defer gpa.free(big_contents);
+    for (big_contents, 0..) |*byte, i| byte.* = @truncate(i *% 31);
+    const files = [_]struct { path: []const u8, contents: []const u8 }{
+        .{ .path = "build.zig", .contents = "const std = @import(\"std\");\n" },
+        .{ .path = "src/main.zig", .contents = "pub fn main() void {}\n" },
+        .{ .path = "src/empty.zig", .contents = "" },
+        .{ .path = "script", .contents = "#!/bin/sh\necho hi\n" },
+        .{ .path = "data/big.bin", .contents = big_contents },
+    };
+
+    const tarball_name = "streamed.tar";
+    {
+        var tarball = try tmp.dir.createFile(tarball_name, .{});
+        defer tarball.close();
+        var buffered_writer = std.io.bufferedWriter(tarball.writer());
+        const w = buffered_writer.writer();
+        for (files) |file| {
+            var file_header = std.tar.output.Header.init();
+            file_header.typeflag = .regular;
+            try file_header.setPath("pkg", file.path);
+            try file_header.setSize(file.contents.len);
+            try file_header.updateChecksum();
+            try w.writeAll(std.mem.asBytes(&file_header));
+            try w.writeAll(file.contents);
+            try w.writeByteNTimes(0, (512 - file.contents.len % 512) % 512);
+        }
+        try w.writeByteNTimes(0, 512 * 2);
+        try buffered_writer.flush();
+    }
+    const tarball_path = try std.fmt.allocPrint(gpa, ".zig-cache/tmp/{s}/{s}", .{ tmp.sub_path, tarball_name });
+    defer gpa.free(tarball_path);
+
+    var fb: TestFetchBuilder = undefined;
+    var fetch = try fb.build(gpa, tmp.dir, tarball_path);
+    defer fb.deinit();
+    try fetch.run();
+
+    // Hash the unpacked package again, reading every file back from disk.
+    var package_dir = try fb.packageDir();
+    defer package_dir.close();
+    const unpack_result: UnpackResult = .{};
+    const rehashed = try computeHash(fetch, .{ .root_dir = .{ .handle = package_dir, .path = null } }, .{}, &unpack_result);
+    try std.testing.expectEqualSlices(u8, &rehashed, &fetch.actual_hash);
+}
+
 fn saveEmbedFile(comptime tarball_name: []const u8, dir: fs.Dir) !void {
     //const tarball_name = "duplicate_paths_excluded.tar.gz";
     const tarball_content = @embedFile("Fetch/testdata/" ++ tarball_name);
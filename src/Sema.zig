@@ -37589,8 +37589,9 @@ fn intAddScalar(sema: *Sema, lhs: Value, rhs: Value, scalar_ty: Type) !Value {
         if (res.overflow_bit.compareAllWithZero(.neq, pt)) return error.Overflow;
         return res.wrapped_result;
     }
-    // TODO is this a performance issue? maybe we should try the operation without
-    // resorting to BigInt first.
+    if (lhs.toSmallInt(pt.zcu)) |lhs_int| {
+        if (rhs.toSmallInt(pt.zcu)) |rhs_int| return pt.intValue(scalar_ty, lhs_int + rhs_int);
+    }
     var lhs_space: Value.BigIntSpace = undefined;
     var rhs_space: Value.BigIntSpace = undefined;
     const lhs_bigint = try lhs.toBigIntAdvanced(&lhs_space, pt, .sema);
@@ -37681,8 +37682,9 @@ fn intSubScalar(sema: *Sema, lhs: Value, rhs: Value, scalar_ty: Type) !Value {
         if (res.overflow_bit.compareAllWithZero(.neq, pt)) return error.Overflow;
         return res.wrapped_result;
     }
-    // TODO is this a performance issue? maybe we should try the operation without
-    // resorting to BigInt first.
+    if (lhs.toSmallInt(pt.zcu)) |lhs_int| {
+        if (rhs.toSmallInt(pt.zcu)) |rhs_int| return pt.intValue(scalar_ty, lhs_int - rhs_int);
+    }
     var lhs_space: Value.BigIntSpace = undefined;
     var rhs_space: Value.BigIntSpace = undefined;
     const lhs_bigint = try lhs.toBigIntAdvanced(&lhs_space, pt, .sema);
@@ -37770,6 +37772,16 @@ fn intSubWithOverflowScalar(
         };
     }
 
+    if (lhs.toSmallInt(mod)) |lhs_int| {
+        if (rhs.toSmallInt(mod)) |rhs_int| {
+            const small_result = lhs_int - rhs_int;
+            if (smallIntFitsInBits(small_result, info.signedness, info.bits)) return .{
+                .overflow_bit = try pt.intValue(Type.u1, 0),
+                .wrapped_result = try pt.intValue(ty, small_result),
+            };
+        }
+    }
+
     var lhs_space: Value.BigIntSpace = undefined;
     var rhs_space: Value.BigIntSpace = undefined;
     const lhs_bigint = try lhs.toBigIntAdvanced(&lhs_space, pt, .sema);
@@ -37787,6 +37799,16 @@ fn intSubWithOverflowScalar(
     };
 }
 
+/// Returns whether `x` is representable by an integer type with `signedness` and
+/// `bits`, where `x` is the sum or difference of two integers of at most 64 bits.
+fn smallIntFitsInBits(x: i128, signedness: std.builtin.Signedness, bits: u16) bool {
+    return switch (signedness) {
+        .unsigned => x >= 0 and (bits >= 65 or x >> @intCast(bits) == 0),
+        .signed => bits >= 66 or (bits > 0 and
+            (x >> @intCast(bits - 1) == 0 or x >> @intCast(bits - 1) == -1)),
+    };
+}
+
 const IntFromFloatMode = enum { exact, truncate };
 
 fn intFromFloat(
@@ -38034,6 +38056,16 @@ fn intAddWithOverflowScalar(
         };
     }
 
+    if (lhs.toSmallInt(mod)) |lhs_int| {
+        if (rhs.toSmallInt(mod)) |rhs_int| {
+            const small_result = lhs_int + rhs_int;
+            if (smallIntFitsInBits(small_result, info.signedness, info.bits)) return .{
+                .overflow_bit = try pt.intValue(Type.u1, 0),
+                .wrapped_result = try pt.intValue(ty, small_result),
+            };
+        }
+    }
+
     var lhs_space: Value.BigIntSpace = undefined;
     var rhs_space: Value.BigIntSpace = undefined;
     const lhs_bigint = try lhs.toBigIntAdvanced(&lhs_space, pt, .sema);
@@ -0,0 +1,206 @@
+//! Collects timing spans from every compiler thread and writes them out in the
+//! Chrome trace event format, which can be loaded into chrome://tracing or
+//! https://ui.perfetto.dev. Enabled with `-ftime-trace=[path]`.
+//!
+//! Unlike `tracy.zig`, this works in any build of the compiler; it is meant for
+//! finding slow declarations in user code rather than slow code in the compiler.
+//!
+//! The trace is cleared at the start of each update, so with `--watch` or the
+//! compiler server the file only ever holds the most recent update.
+
+const TimeTrace = @This();
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+
+gpa: Allocator,
+timer: std.time.Timer,
+/// Protects `events`, `string_bytes` and `generation`.
+mutex: std.Thread.Mutex = .{},
+events: std.ArrayListUnmanaged(Event) = .{},
+/// Span names are copied here since they usually point into the InternPool
+/// or other memory which may be freed before the trace is written.
+string_bytes: std.ArrayListUnmanaged(u8) = .{},
+/// Incremented by `reset`, so that spans which began before it are dropped
+/// rather than ending an unrelated event.
+generation: u32 = 0,
+
+pub const Category = enum {
+    astgen,
+    sema,
+    codegen,
+    link,
+    llvm,
+    /// Time a task spent in a thread pool queue before a worker picked it up.
+    queue,
+};
+
+const Event = struct {
+    category: Category,
+    /// Index into `string_bytes`.
+    name_start: u32,
+    name_len: u32,
+    tid: std.Thread.Id,
+    /// Nanoseconds since `timer` was started.
+    start: u64,
+    duration: u64,
+};
+
+/// A point in time relative to the start of the trace.
+pub const Timestamp = u64;
+
+pub const Span = struct {
+    time_trace: ?*TimeTrace,
+    /// Index into `events`, or `null` if the event could not be allocated.
+    event: ?u32,
+    generation: u32,
+
+    pub fn end(span: Span) void {
+        const tt = span.time_trace orelse return;
+        const event = span.event orelse return;
+        const end_time = tt.now();
+
+        tt.mutex.lock();
+        defer tt.mutex.unlock();
+
+        if (span.generation != tt.generation) return;
+        const item = &tt.events.items[event];
+        item.duration = end_time -| item.start;
+    }
+};
+
+pub fn init(gpa: Allocator) !TimeTrace {
+    return .{
+        .gpa = gpa,
+        .timer = try std.time.Timer.start(),
+    };
+}
+
+pub fn deinit(tt: *TimeTrace) void {
+    tt.events.deinit(tt.gpa);
+    tt.string_bytes.deinit(tt.gpa);
+    tt.* = undefined;
+}
+
+/// Discards every event and restarts the clock.
+pub fn reset(tt: *TimeTrace) void {
+    tt.mutex.lock();
+    defer tt.mutex.unlock();
+
+    tt.events.clearRetainingCapacity();
+    tt.string_bytes.clearRetainingCapacity();
+    tt.generation +%= 1;
+    tt.timer.reset();
+}
+
+pub fn now(tt: *TimeTrace) Timestamp {
+    return tt.timer.read();
+}
+
+/// Starts a span on the calling thread. `name` is copied, so it only needs
+/// to be valid for the duration of this call. A null `time_trace` makes this
+/// a no-op, so callers can unconditionally pass `comp.time_trace`.
+pub fn begin(time_trace: ?*TimeTrace, category: Category, name: []const u8) Span {
+    const tt = time_trace orelse return .{ .time_trace = null, .event = null, .generation = 0 };
+    tt.mutex.lock();
+    const generation = tt.generation;
+    tt.mutex.unlock();
+    return .{ .time_trace = tt, .event = tt.addEvent(category, name, tt.now(), 0), .generation = generation };
+}
+
+/// Records a completed span on the calling thread.
+pub fn record(tt: *TimeTrace, category: Category, name: []const u8, start: Timestamp, end: Timestamp) void {
+    _ = tt.addEvent(category, name, start, end -| start);
+}
+
+/// Allocation failures drop the event; a partial trace is preferable to
+/// failing the compilation.
+fn addEvent(tt: *TimeTrace, category: Category, name: []const u8, start: Timestamp, duration: u64) ?u32 {
+    const tid = std.Thread.getCurrentId();
+
+    tt.mutex.lock();
+    defer tt.mutex.unlock();
+
+    tt.events.ensureUnusedCapacity(tt.gpa, 1) catch return null;
+    const name_start: u32 = @intCast(tt.string_bytes.items.len);
+    tt.string_bytes.appendSlice(tt.gpa, name) catch return null;
+    const index: u32 = @intCast(tt.events.items.len);
+    tt.events.appendAssumeCapacity(.{
+        .category = category,
+        .name_start = name_start,
+        .name_len = @intCast(name.len),
+        .tid = tid,
+        .start = start,
+        .duration = duration,
+    });
+    return index;
+}
+
+pub fn writeFile(tt: *TimeTrace, path: []const u8) !void {
+    const file = try std.fs.cwd().createFile(path, .{});
+    defer file.close();
+
+    var bw = std.io.bufferedWriter(file.writer());
+    try tt.write(bw.writer());
+    try bw.flush();
+}
+
+pub fn write(tt: *TimeTrace, writer: anytype) !void {
+    tt.mutex.lock();
+    defer tt.mutex.unlock();
+
+    try writer.writeAll("{\"traceEvents\":[\n");
+    for (tt.events.items, 0..) |event, i| {
+        if (i != 0) try writer.writeAll(",\n");
+        try writer.writeAll("{\"name\":");
+        const name = tt.string_bytes.items[event.name_start..][0..event.name_len];
+        try std.json.encodeJsonString(name, .{}, writer);
+        // Timestamps are in microseconds; keep sub-microsecond precision so
+        // that short spans are not rounded away.
+        try writer.print(",\"cat\":\"{s}\",\"ph\":\"X\",\"pid\":1,\"tid\":{d},\"ts\":{d}.{d:0>3},\"dur\":{d}.{d:0>3}}}", .{
+            @tagName(event.category),
+            event.tid,
+            event.start / std.time.ns_per_us,
+            event.start % std.time.ns_per_us,
+            event.duration / std.time.ns_per_us,
+            event.duration % std.time.ns_per_us,
+        });
+    }
+    try writer.writeAll("\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+test write {
+    var tt = try TimeTrace.init(std.testing.allocator);
+    defer tt.deinit();
+
+    tt.record(.astgen, "foo.zig", 1500, 2750);
+    tt.record(.sema, "a\"b", 3000, 3000);
+
+    var buf = std.ArrayList(u8).init(std.testing.allocator);
+    defer buf.deinit();
+    try tt.write(buf.writer());
+
+    const tid = std.Thread.getCurrentId();
+    const expected = try std.fmt.allocPrint(std.testing.allocator,
+        \\{{"traceEvents":[
+        \\{{"name":"foo.zig","cat":"astgen","ph":"X","pid":1,"tid":{d},"ts":1.500,"dur":1.250}},
+        \\{{"name":"a\"b","cat":"sema","ph":"X","pid":1,"tid":{d},"ts":3.000,"dur":0.000}}
+        \\],"displayTimeUnit":"ms"}}
+        \\
+    , .{ tid, tid });
+    defer std.testing.allocator.free(expected);
+    try std.testing.expectEqualStrings(expected, buf.items);
+}
+
+test reset {
+    var tt = try TimeTrace.init(std.testing.allocator);
+    defer tt.deinit();
+
+    const span = TimeTrace.begin(&tt, .sema, "before");
+    tt.reset();
+    span.end();
+    tt.record(.link, "after", 0, 1000);
+
+    try std.testing.expectEqual(1, tt.events.items.len);
+    try std.testing.expectEqualStrings("after", tt.string_bytes.items);
+}
@@ -234,6 +234,20 @@ pub fn getVariable(val: Value, mod: *Module) ?InternPool.Key.Variable {
     };
 }
 
+/// Returns the value of an integer which the `InternPool` stores in 64 bits or
+/// less, otherwise null. Unlike `toBigInt`, this never resolves lazy values,
+/// so it is cheap enough to try before falling back to big integer arithmetic.
+pub fn toSmallInt(val: Value, zcu: *const Zcu) ?i128 {
+    return switch (zcu.intern_pool.indexToKey(val.toIntern())) {
+        .int => |int| switch (int.storage) {
+            .u64 => |x| x,
+            .i64 => |x| x,
+            .big_int, .lazy_align, .lazy_size => null,
+        },
+        else => null,
+    };
+}
+
 /// If the value fits in a u64, return it, otherwise null.
 /// Asserts not undefined.
 pub fn getUnsignedInt(val: Value, pt: Zcu.PerThread) ?u64 {
@@ -1075,6 +1089,9 @@ pub fn order(lhs: Value, rhs: Value, pt: Zcu.PerThread) std.math.Order {
 
 /// Asserts the value is comparable.
 pub fn orderAdvanced(lhs: Value, rhs: Value, pt: Zcu.PerThread, comptime strat: ResolveStrat) !std.math.Order {
+    if (lhs.toSmallInt(pt.zcu)) |lhs_int| {
+        if (rhs.toSmallInt(pt.zcu)) |rhs_int| return std.math.order(lhs_int, rhs_int);
+    }
     const lhs_against_zero = try lhs.orderAgainstZeroAdvanced(pt, strat);
     const rhs_against_zero = try rhs.orderAgainstZeroAdvanced(pt, strat);
     switch (lhs_against_zero) {
@@ -578,12 +578,15 @@ pub fn ensureCauAnalyzed(pt: Zcu.PerThread, cau_index: InternPool.Cau.Index) Zcu
             };
         }
 
-        const decl_prog_node = zcu.sema_prog_node.start(switch (cau.owner.unwrap()) {
+        const decl_name = switch (cau.owner.unwrap()) {
             .nav => |nav| ip.getNav(nav).fqn.toSlice(ip),
             .type => |ty| Type.fromInterned(ty).containerTypeName(ip).toSlice(ip),
             .none => "comptime",
-        }, 0);
+        };
+        const decl_prog_node = zcu.sema_prog_node.start(decl_name, 0);
         defer decl_prog_node.end();
+        const time_trace_span = zcu.comp.timeTraceBegin(.sema, decl_name);
+        defer time_trace_span.end();
 
         break :res pt.semaCau(cau_index) catch |err| switch (err) {
             error.AnalysisFail => {
@@ -769,6 +772,8 @@ pub fn linkerUpdateFunc(pt: Zcu.PerThread, func_index: InternPool.Index, air: Ai
     const nav_index = func.owner_nav;
     const nav = ip.getNav(nav_index);
 
+    if (comp.air_optimize) try Air.Optimize.run(gpa, air);
+
     var liveness = try Liveness.analyze(gpa, air, ip);
     defer liveness.deinit(gpa);
 
@@ -803,6 +808,8 @@ pub fn linkerUpdateFunc(pt: Zcu.PerThread, func_index: InternPool.Index, air: Ai
 
     const codegen_prog_node = zcu.codegen_prog_node.start(nav.fqn.toSlice(ip), 0);
     defer codegen_prog_node.end();
+    const time_trace_span = comp.timeTraceBegin(.codegen, nav.fqn.toSlice(ip));
+    defer time_trace_span.end();
 
     if (!air.typesFullyResolved(zcu)) {
         // A type we depend on failed to resolve. This is a transitive failure.
@@ -2026,6 +2033,8 @@ fn analyzeFnBody(pt: Zcu.PerThread, func_index: InternPool.Index) Zcu.SemaError!
 
     const decl_prog_node = zcu.sema_prog_node.start(func_nav.fqn.toSlice(ip), 0);
     defer decl_prog_node.end();
+    const time_trace_span = zcu.comp.timeTraceBegin(.sema, func_nav.fqn.toSlice(ip));
+    defer time_trace_span.end();
 
     zcu.intern_pool.removeDependenciesForDepender(gpa, anal_unit);
 
@@ -2555,6 +2564,8 @@ pub fn linkerUpdateNav(pt: Zcu.PerThread, nav_index: InternPool.Nav.Index) !void
     const nav = zcu.intern_pool.getNav(nav_index);
     const codegen_prog_node = zcu.codegen_prog_node.start(nav.fqn.toSlice(&zcu.intern_pool), 0);
     defer codegen_prog_node.end();
+    const time_trace_span = comp.timeTraceBegin(.codegen, nav.fqn.toSlice(&zcu.intern_pool));
+    defer time_trace_span.end();
 
     if (comp.bin_file) |lf| {
         lf.updateNav(pt, nav_index) catch |err| switch (err) {
@@ -18011,6 +18011,72 @@ fn airReduce(self: *Self, inst: Air.Inst.Index) !void {
                 else => return self.fail("TODO implement airReduce for {}", .{operand_ty.fmt(pt)}),
             }
         }
+        if (operand_ty.isVector(mod)) simd: {
+            // Reduce in log2(len) steps by combining each vector with a copy of
+            // itself shifted down by half of the remaining width.
+            const scalar_ty = operand_ty.childType(mod);
+            if (!scalar_ty.isInt(mod)) break :simd;
+            const elem_size: u32 = @intCast(scalar_ty.abiSize(pt));
+            if (scalar_ty.intInfo(mod).bits != elem_size * 8) break :simd;
+            const vector_len = operand_ty.vectorLen(mod);
+            if (vector_len == 0 or !math.isPowerOfTwo(vector_len)) break :simd;
+            const vector_size = vector_len * elem_size;
+            if (vector_size > 16) break :simd;
+
+            const mir_tag: Mir.Inst.FixedTag = switch (reduce.operation) {
+                .Add => if (self.hasFeature(.avx)) switch (elem_size) {
+                    1 => .{ .vp_b, .add },
+                    2 => .{ .vp_w, .add },
+                    4 => .{ .vp_d, .add },
+                    8 => .{ .vp_q, .add },
+                    else => unreachable,
+                } else switch (elem_size) {
+                    1 => .{ .p_b, .add },
+                    2 => .{ .p_w, .add },
+                    4 => .{ .p_d, .add },
+                    8 => .{ .p_q, .add },
+                    else => unreachable,
+                },
+                .And => if (self.hasFeature(.avx)) .{ .vp_, .@"and" } else .{ .p_, .@"and" },
+                .Or => if (self.hasFeature(.avx)) .{ .vp_, .@"or" } else .{ .p_, .@"or" },
+                .Xor => if (self.hasFeature(.avx)) .{ .vp_, .xor } else .{ .p_, .xor },
+                .Min, .Max, .Mul => break :simd,
+            };
+
+            const operand_mcv = try self.resolveInst(reduce.operand);
+            const vec_reg = try self.copyToTmpRegister(operand_ty, operand_mcv);
+            const vec_lock = self.register_manager.lockRegAssumeUnused(vec_reg);
+            defer self.register_manager.unlockReg(vec_lock);
+            const tmp_reg = try self.register_manager.allocReg(null, abi.RegisterClass.sse);
+            const tmp_lock = self.register_manager.lockRegAssumeUnused(tmp_reg);
+            defer self.register_manager.unlockReg(tmp_lock);
+
+            var width = vector_size / 2;
+            while (width >= elem_size) : (width /= 2) {
+                if (self.hasFeature(.avx)) {
+                    try self.asmRegisterRegisterImmediate(
+                        .{ .vp_dq, .srl },
+                        tmp_reg.to128(),
+                        vec_reg.to128(),
+                        Immediate.u(width),
+                    );
+                    try self.asmRegisterRegisterRegister(
+                        mir_tag,
+                        vec_reg.to128(),
+                        vec_reg.to128(),
+                        tmp_reg.to128(),
+                    );
+                } else {
+                    try self.genSetReg(tmp_reg, operand_ty, .{ .register = vec_reg }, .{});
+                    try self.asmRegisterImmediate(.{ .p_dq, .srl }, tmp_reg.to128(), Immediate.u(width));
+                    try self.asmRegisterRegister(mir_tag, vec_reg.to128(), tmp_reg.to128());
+                }
+            }
+
+            const dst_reg = try self.register_manager.allocReg(inst, abi.RegisterClass.gp);
+            try self.genSetReg(dst_reg, scalar_ty, .{ .register = vec_reg }, .{});
+            break :result .{ .register = dst_reg };
+        }
         return self.fail("TODO implement airReduce for {}", .{operand_ty.fmt(pt)});
     };
     return self.finishAir(inst, result, .{ reduce.operand, .none, .none });
@@ -11,12 +11,19 @@ prev_di_pc: usize,
 
 code_offset_mapping: std.AutoHashMapUnmanaged(Mir.Inst.Index, usize) = .{},
 relocs: std.ArrayListUnmanaged(Reloc) = .{},
+/// For every `jmp`/`jcc` to another MIR instruction, in emission order,
+/// whether it is emitted with an 8-bit displacement. See `relaxBranches`.
+short_branches: std.DynamicBitSetUnmanaged = .{},
 
 pub const Error = Lower.Error || error{
     EmitFail,
 };
 
 pub fn emitMir(emit: *Emit) Error!void {
+    threadJumps(emit.lower.mir.instructions);
+    try emit.relaxBranches();
+
+    var branch_index: usize = 0;
     for (0..emit.lower.mir.instructions.len) |mir_i| {
         const mir_index: Mir.Inst.Index = @intCast(mir_i);
         try emit.code_offset_mapping.putNoClobber(
@@ -29,6 +36,19 @@ pub fn emitMir(emit: *Emit) Error!void {
         for (lowered.insts, 0..) |lowered_inst, lowered_index| {
             const start_offset: u32 = @intCast(emit.code.items.len);
             try lowered_inst.encode(emit.code.writer(), .{});
+            var width: Reloc.Width = .rel32;
+            if (lowered_relocs.len > 0 and lowered_relocs[0].lowered_inst_index == lowered_index and
+                lowered_relocs[0].target == .inst and isBranch(emit.code.items[start_offset..]))
+            {
+                if (branch_index < emit.short_branches.bit_length and
+                    emit.short_branches.isSet(branch_index))
+                {
+                    shortenBranch(emit.code.items[start_offset..]);
+                    emit.code.shrinkRetainingCapacity(start_offset + 2);
+                    width = .rel8;
+                }
+                branch_index += 1;
+            }
             const end_offset: u32 = @intCast(emit.code.items.len);
             while (lowered_relocs.len > 0 and
                 lowered_relocs[0].lowered_inst_index == lowered_index) : ({
@@ -37,8 +57,12 @@ pub fn emitMir(emit: *Emit) Error!void {
                 .inst => |target| try emit.relocs.append(emit.lower.allocator, .{
                     .source = start_offset,
                     .target = target,
-                    .offset = end_offset - 4,
+                    .offset = end_offset - @as(u32, switch (width) {
+                        .rel8 => 1,
+                        .rel32 => 4,
+                    }),
                     .length = @intCast(end_offset - start_offset),
+                    .width = width,
                 }),
                 .linker_extern_fn => |symbol| if (emit.lower.bin_file.cast(.elf)) |elf_file| {
                     // Add relocation to the decl.
@@ -290,15 +314,201 @@ pub fn emitMir(emit: *Emit) Error!void {
             }
         }
     }
+    assert(emit.short_branches.bit_length == 0 or branch_index == emit.short_branches.bit_length);
     try emit.fixupRelocs();
 }
 
 pub fn deinit(emit: *Emit) void {
     emit.relocs.deinit(emit.lower.allocator);
     emit.code_offset_mapping.deinit(emit.lower.allocator);
+    emit.short_branches.deinit(emit.lower.allocator);
     emit.* = undefined;
 }
 
+/// Retargets jumps whose target is an unconditional `jmp` to that jump's
+/// target, then removes unconditional jumps to the code which immediately
+/// follows them.
+fn threadJumps(instructions: std.MultiArrayList(Mir.Inst).Slice) void {
+    const tags = instructions.items(.tag);
+    const ops = instructions.items(.ops);
+    const datas = instructions.items(.data);
+    for (0..instructions.len) |mir_i| {
+        switch (tags[mir_i]) {
+            .j, .jmp => if (ops[mir_i] != .inst) continue,
+            .pseudo => switch (ops[mir_i]) {
+                .pseudo_j_z_and_np_inst, .pseudo_j_nz_or_p_inst => {},
+                else => continue,
+            },
+            else => continue,
+        }
+        const target = &datas[mir_i].inst.inst;
+        // Bound the search so that a cycle of jumps cannot hang compilation.
+        for (0..8) |_| {
+            const next = target.*;
+            if (next >= instructions.len or next == mir_i) break;
+            if (tags[next] != .jmp or ops[next] != .inst or datas[next].inst.fixes != ._) break;
+            if (datas[next].inst.inst == next) break;
+            target.* = datas[next].inst.inst;
+        }
+    }
+
+    for (0..instructions.len) |mir_i| {
+        if (tags[mir_i] != .jmp or ops[mir_i] != .inst or datas[mir_i].inst.fixes != ._) continue;
+        const target = datas[mir_i].inst.inst;
+        if (target <= mir_i) continue;
+        for (mir_i + 1..target) |between_i| switch (tags[between_i]) {
+            .pseudo => switch (ops[between_i]) {
+                .pseudo_dbg_prologue_end_none,
+                .pseudo_dbg_line_line_column,
+                .pseudo_dbg_epilogue_begin_none,
+                .pseudo_dbg_inline_func,
+                .pseudo_dead_none,
+                => {},
+                else => break,
+            },
+            else => break,
+        } else {
+            tags[mir_i] = .pseudo;
+            ops[mir_i] = .pseudo_dead_none;
+            datas[mir_i] = .{ .none = .{} };
+        }
+    }
+}
+
+/// Decides which branches to other MIR instructions can use an 8-bit
+/// displacement, by laying out the function with every branch in its
+/// 32-bit form and passing the result to `selectShortBranches`.
+/// Functions without such branches skip the layout pass and leave
+/// `short_branches` empty.
+fn relaxBranches(emit: *Emit) Error!void {
+    const gpa = emit.lower.allocator;
+    const mir = emit.lower.mir;
+    const mir_len = mir.instructions.len;
+
+    if (!hasInstBranches(mir.instructions)) return;
+
+    var branches: std.ArrayListUnmanaged(Branch) = .{};
+    defer branches.deinit(gpa);
+    // One extra entry, since a branch can target the end of the function.
+    const mir_offsets = try gpa.alloc(u32, mir_len + 1);
+    defer gpa.free(mir_offsets);
+
+    var offset: u32 = 0;
+    for (0..mir_len) |mir_i| {
+        mir_offsets[mir_i] = offset;
+        const lowered = try emit.lower.lowerMir(@intCast(mir_i));
+        var lowered_relocs = lowered.relocs;
+        for (lowered.insts, 0..) |lowered_inst, lowered_index| {
+            var buf: [16]u8 = undefined;
+            var stream = std.io.fixedBufferStream(&buf);
+            lowered_inst.encode(stream.writer(), .{}) catch |err| switch (err) {
+                error.NoSpaceLeft => unreachable, // x86 instructions are at most 15 bytes
+                else => |e| return e,
+            };
+            const code = stream.getWritten();
+            while (lowered_relocs.len > 0 and lowered_relocs[0].lowered_inst_index == lowered_index) : ({
+                lowered_relocs = lowered_relocs[1..];
+            }) switch (lowered_relocs[0].target) {
+                .inst => |target| if (isBranch(code)) try branches.append(gpa, .{
+                    .source = offset,
+                    .saving = @intCast(code.len - 2),
+                    .target = target,
+                }),
+                else => {},
+            };
+            offset += @intCast(code.len);
+        }
+    }
+    mir_offsets[mir_len] = offset;
+
+    try selectShortBranches(gpa, branches.items, mir_offsets, &emit.short_branches);
+}
+
+/// Whether any instruction may lower to a branch to another MIR instruction.
+fn hasInstBranches(instructions: std.MultiArrayList(Mir.Inst).Slice) bool {
+    for (instructions.items(.ops)) |ops| switch (ops) {
+        .inst,
+        .pseudo_j_z_and_np_inst,
+        .pseudo_j_nz_or_p_inst,
+        .pseudo_probe_align_ri_s,
+        .pseudo_probe_adjust_loop_rr,
+        => return true,
+        else => {},
+    };
+    return false;
+}
+
+const Branch = struct {
+    /// Offset of the 32-bit form of the instruction.
+    source: u32,
+    /// Bytes saved by using the 8-bit form.
+    saving: u32,
+    target: Mir.Inst.Index,
+};
+
+/// Sets `short_branches[i]` for every branch in `branches`, which are sorted
+/// by `source`, that fits in an 8-bit displacement once the selected branches
+/// are shortened. `mir_offsets` maps each MIR instruction to its offset when
+/// every branch has its 32-bit form. Shrinking a branch never increases the
+/// distance spanned by any other branch, so each pass can only shrink more.
+fn selectShortBranches(
+    gpa: mem.Allocator,
+    branches: []const Branch,
+    mir_offsets: []const u32,
+    short_branches: *std.DynamicBitSetUnmanaged,
+) mem.Allocator.Error!void {
+    try short_branches.resize(gpa, branches.len, false);
+    // `removed[i]` is the number of bytes saved by the short branches in `branches[0..i]`.
+    const removed = try gpa.alloc(u32, branches.len + 1);
+    defer gpa.free(removed);
+
+    var changed = true;
+    while (changed) {
+        changed = false;
+        removed[0] = 0;
+        for (branches, 0..) |branch, i| {
+            removed[i + 1] = removed[i] + if (short_branches.isSet(i)) branch.saving else 0;
+        }
+        for (branches, 0..) |branch, i| {
+            if (short_branches.isSet(i)) continue;
+            const target_offset = mir_offsets[branch.target];
+            // Branches located before the target instruction.
+            const before_target = std.sort.lowerBound(Branch, branches, target_offset, struct {
+                fn order(context: u32, item: Branch) std.math.Order {
+                    return std.math.order(item.source, context);
+                }
+            }.order);
+            const source: i64 = branch.source - removed[i];
+            var target: i64 = target_offset - removed[before_target];
+            // A forward branch also moves its target by shrinking itself.
+            if (target_offset > branch.source) target -= branch.saving;
+            if (std.math.cast(i8, target - (source + 2)) != null) {
+                short_branches.set(i);
+                changed = true;
+            }
+        }
+    }
+}
+
+/// Whether `code` is a `jmp rel32` or `jcc rel32`.
+fn isBranch(code: []const u8) bool {
+    return switch (code[0]) {
+        0xe9 => code.len == 5,
+        0x0f => code.len == 6 and code[1] & 0xf0 == 0x80,
+        else => false,
+    };
+}
+
+/// Rewrites a `jmp rel32` or `jcc rel32` into its `rel8` form in place.
+fn shortenBranch(code: []u8) void {
+    switch (code[0]) {
+        0xe9 => code[0] = 0xeb,
+        0x0f => code[0] = 0x70 | (code[1] & 0x0f),
+        else => unreachable,
+    }
+    code[1] = 0;
+}
+
 fn fail(emit: *Emit, comptime format: []const u8, args: anytype) Error {
     return switch (emit.lower.fail(format, args)) {
         error.LowerFail => error.EmitFail,
@@ -315,18 +525,20 @@ const Reloc = struct {
     offset: u32,
     /// Length of the instruction.
     length: u5,
+    width: Width,
+
+    const Width = enum { rel8, rel32 };
 };
 
 fn fixupRelocs(emit: *Emit) Error!void {
-    // TODO this function currently assumes all relocs via JMP/CALL instructions are 32bit in size.
-    // This should be reversed like it is done in aarch64 MIR emit code: start with the smallest
-    // possible resolution, i.e., 8bit, and iteratively converge on the minimum required resolution
-    // until the entire decl is correctly emitted with all JMP/CALL instructions within range.
     for (emit.relocs.items) |reloc| {
         const target = emit.code_offset_mapping.get(reloc.target) orelse
             return emit.fail("JMP/CALL relocation target not found!", .{});
         const disp = @as(i64, @intCast(target)) - @as(i64, @intCast(reloc.source + reloc.length));
-        mem.writeInt(i32, emit.code.items[reloc.offset..][0..4], @intCast(disp), .little);
+        switch (reloc.width) {
+            .rel8 => mem.writeInt(i8, emit.code.items[reloc.offset..][0..1], @intCast(disp), .little),
+            .rel32 => mem.writeInt(i32, emit.code.items[reloc.offset..][0..4], @intCast(disp), .little),
+        }
     }
 }
 
@@ -379,10 +591,91 @@ fn dbgAdvancePCAndLine(emit: *Emit, line: u32, column: u32) Error!void {
     }
 }
 
+fn testShortBranches(branches: []const Branch, mir_offsets: []const u32, expected: []const bool) !void {
+    var short_branches: std.DynamicBitSetUnmanaged = .{};
+    defer short_branches.deinit(testing.allocator);
+    try selectShortBranches(testing.allocator, branches, mir_offsets, &short_branches);
+    try testing.expectEqual(expected.len, short_branches.bit_length);
+    for (expected, 0..) |is_short, i| try testing.expectEqual(is_short, short_branches.isSet(i));
+}
+
+test "rel8 forward jmp at the displacement limit" {
+    // The target moves back by the 3 bytes the jmp itself saves.
+    try testShortBranches(&.{.{ .source = 0, .saving = 3, .target = 1 }}, &.{ 0, 132 }, &.{true});
+    try testShortBranches(&.{.{ .source = 0, .saving = 3, .target = 1 }}, &.{ 0, 133 }, &.{false});
+}
+
+test "rel8 forward jcc at the displacement limit" {
+    try testShortBranches(&.{.{ .source = 0, .saving = 4, .target = 1 }}, &.{ 0, 133 }, &.{true});
+    try testShortBranches(&.{.{ .source = 0, .saving = 4, .target = 1 }}, &.{ 0, 134 }, &.{false});
+}
+
+test "rel8 backward jmp at the displacement limit" {
+    try testShortBranches(&.{.{ .source = 126, .saving = 3, .target = 0 }}, &.{ 0, 126 }, &.{true});
+    try testShortBranches(&.{.{ .source = 127, .saving = 3, .target = 0 }}, &.{ 0, 127 }, &.{false});
+}
+
+test "rel8 branch brought into range by shortening an inner branch" {
+    try testShortBranches(&.{
+        .{ .source = 0, .saving = 3, .target = 2 },
+        .{ .source = 5, .saving = 3, .target = 1 },
+    }, &.{ 0, 10, 135 }, &.{ true, true });
+    try testShortBranches(&.{
+        .{ .source = 0, .saving = 3, .target = 2 },
+        .{ .source = 5, .saving = 3, .target = 1 },
+    }, &.{ 0, 10, 136 }, &.{ false, true });
+}
+
+test "threadJumps retargets jump chains and removes jumps to the next instruction" {
+    var instructions: std.MultiArrayList(Mir.Inst) = .{};
+    defer instructions.deinit(testing.allocator);
+    for ([_]Mir.Inst{
+        .{ .tag = .j, .ops = .inst, .data = .{ .inst = .{ .fixes = ._z, .inst = 2 } } },
+        .{ .tag = .nop, .ops = .none, .data = .{ .none = .{} } },
+        .{ .tag = .jmp, .ops = .inst, .data = .{ .inst = .{ .inst = 4 } } },
+        .{ .tag = .nop, .ops = .none, .data = .{ .none = .{} } },
+        .{ .tag = .jmp, .ops = .inst, .data = .{ .inst = .{ .inst = 5 } } },
+        .{ .tag = .nop, .ops = .none, .data = .{ .none = .{} } },
+    }) |inst| try instructions.append(testing.allocator, inst);
+    const slice = instructions.slice();
+    threadJumps(slice);
+
+    const tags = slice.items(.tag);
+    const ops = slice.items(.ops);
+    const datas = slice.items(.data);
+    try testing.expectEqual(Mir.Inst.Tag.j, tags[0]);
+    try testing.expectEqual(Mir.Inst.Fixes._z, datas[0].inst.fixes);
+    try testing.expectEqual(5, datas[0].inst.inst);
+    try testing.expectEqual(Mir.Inst.Tag.jmp, tags[2]);
+    try testing.expectEqual(5, datas[2].inst.inst);
+    try testing.expectEqual(Mir.Inst.Tag.pseudo, tags[4]);
+    try testing.expectEqual(Mir.Inst.Ops.pseudo_dead_none, ops[4]);
+}
+
+test "threadJumps terminates on a cycle of jumps" {
+    var instructions: std.MultiArrayList(Mir.Inst) = .{};
+    defer instructions.deinit(testing.allocator);
+    for ([_]Mir.Inst{
+        .{ .tag = .jmp, .ops = .inst, .data = .{ .inst = .{ .inst = 1 } } },
+        .{ .tag = .jmp, .ops = .inst, .data = .{ .inst = .{ .inst = 0 } } },
+    }) |inst| try instructions.append(testing.allocator, inst);
+    const slice = instructions.slice();
+    threadJumps(slice);
+
+    const tags = slice.items(.tag);
+    const datas = slice.items(.data);
+    try testing.expectEqual(Mir.Inst.Tag.jmp, tags[0]);
+    try testing.expectEqual(0, datas[0].inst.inst);
+    try testing.expectEqual(Mir.Inst.Tag.jmp, tags[1]);
+    try testing.expectEqual(0, datas[1].inst.inst);
+}
+
+const assert = std.debug.assert;
 const link = @import("../../link.zig");
 const log = std.log.scoped(.emit);
 const mem = std.mem;
 const std = @import("std");
+const testing = std.testing;
 
 const DebugInfoOutput = @import("../../codegen.zig").DebugInfoOutput;
 const Emit = @This();
@@ -166,18 +166,18 @@ pub const ASTUnit = opaque {
     pub const getSourceManager = ZigClangASTUnit_getSourceManager;
     extern fn ZigClangASTUnit_getSourceManager(*ASTUnit) *SourceManager;
 
-    pub const visitLocalTopLevelDecls = ZigClangASTUnit_visitLocalTopLevelDecls;
-    extern fn ZigClangASTUnit_visitLocalTopLevelDecls(
+    pub const visitTopLevelDecls = ZigClangASTUnit_visitTopLevelDecls;
+    extern fn ZigClangASTUnit_visitTopLevelDecls(
         *ASTUnit,
         context: ?*anyopaque,
         Fn: ?*const fn (?*anyopaque, *const Decl) callconv(.C) bool,
     ) bool;
 
-    pub const getLocalPreprocessingEntities_begin = ZigClangASTUnit_getLocalPreprocessingEntities_begin;
-    extern fn ZigClangASTUnit_getLocalPreprocessingEntities_begin(*ASTUnit) PreprocessingRecord.iterator;
+    pub const getPreprocessingEntities_begin = ZigClangASTUnit_getPreprocessingEntities_begin;
+    extern fn ZigClangASTUnit_getPreprocessingEntities_begin(*ASTUnit) PreprocessingRecord.iterator;
 
-    pub const getLocalPreprocessingEntities_end = ZigClangASTUnit_getLocalPreprocessingEntities_end;
-    extern fn ZigClangASTUnit_getLocalPreprocessingEntities_end(*ASTUnit) PreprocessingRecord.iterator;
+    pub const getPreprocessingEntities_end = ZigClangASTUnit_getPreprocessingEntities_end;
+    extern fn ZigClangASTUnit_getPreprocessingEntities_end(*ASTUnit) PreprocessingRecord.iterator;
 };
 
 pub const ArraySubscriptExpr = opaque {
@@ -542,6 +542,9 @@ pub const FunctionDecl = opaque {
     pub const hasBody = ZigClangFunctionDecl_hasBody;
     extern fn ZigClangFunctionDecl_hasBody(*const FunctionDecl) bool;
 
+    pub const hasSkippedBody = ZigClangFunctionDecl_hasSkippedBody;
+    extern fn ZigClangFunctionDecl_hasSkippedBody(*const FunctionDecl) bool;
+
     pub const getStorageClass = ZigClangFunctionDecl_getStorageClass;
     extern fn ZigClangFunctionDecl_getStorageClass(*const FunctionDecl) StorageClass;
 
@@ -2208,6 +2211,7 @@ extern fn ZigClangLoadFromCommandLine(
     errors_ptr: *[*]ErrorMsg,
     errors_len: *usize,
     resources_path: [*:0]const u8,
+    skip_function_bodies: bool,
 ) ?*ASTUnit;
 
 pub const isLLVMUsingSeparateLibcxx = ZigClangIsLLVMUsingSeparateLibcxx;
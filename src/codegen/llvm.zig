@@ -29,6 +29,7 @@ const riscv_c_abi = @import("../arch/riscv64/abi.zig");
 const dev = @import("../dev.zig");
 
 const target_util = @import("../target.zig");
+const Cache = std.Build.Cache;
 const libcFloatPrefix = target_util.libcFloatPrefix;
 const libcFloatSuffix = target_util.libcFloatSuffix;
 const compilerRtFloatAbbrev = target_util.compilerRtFloatAbbrev;
@@ -1094,7 +1095,7 @@ pub const Object = struct {
         time_report: bool,
         sanitize_thread: bool,
         fuzz: bool,
-        lto: bool,
+        lto: std.zig.LtoMode,
     };
 
     pub fn emit(self: *Object, options: EmitOptions) !void {
@@ -1144,6 +1145,7 @@ pub const Object = struct {
             emit_asm_msg, emit_bin_msg, post_llvm_ir_msg, post_llvm_bc_msg,
         });
 
+        var object_cache_digest: ?Cache.HexDigest = null;
         const context, const module = emit: {
             if (options.pre_ir_path) |path| {
                 if (std.mem.eql(u8, path, "-")) {
@@ -1176,6 +1178,19 @@ pub const Object = struct {
                 try file.writeAll(ptr[0..(bitcode.len * 4)]);
             }
 
+            // The same bitcode emitted with the same options always results in
+            // the same object file. Updates which change neither the generated
+            // code nor its debug info, such as edits of unreferenced declarations,
+            // reuse the object last emitted for the same output instead of
+            // running LLVM again.
+            // With debug info, edits which move code to other lines (including
+            // comment edits) change the bitcode and so still miss.
+            if (options.bin_path != null and options.asm_path == null and options.post_ir_path == null) {
+                const digest = self.objectCacheDigest(bitcode, options);
+                if (self.copyCachedObject(digest, std.mem.span(options.bin_path.?), options)) return;
+                object_cache_digest = digest;
+            }
+
             if (!build_options.have_llvm or !comp.config.use_lib_llvm) {
                 log.err("emitting without libllvm not implemented", .{});
                 return error.FailedToEmit;
@@ -1276,7 +1291,11 @@ pub const Object = struct {
             .time_report = options.time_report,
             .tsan = options.sanitize_thread,
             .sancov = options.fuzz,
-            .lto = options.lto,
+            .lto = switch (options.lto) {
+                .none => .None,
+                .full => .Full,
+                .thin => .Thin,
+            },
             .asm_filename = null,
             .bin_filename = options.bin_path,
             .llvm_ir_filename = options.post_ir_path,
@@ -1301,6 +1320,11 @@ pub const Object = struct {
                 .CollectControlFlow = false,
             },
         };
+        if (options.bin_path) |bin_path| {
+            // The object may be a hard link to a cached one, which LLVM must
+            // not truncate and rewrite in place.
+            std.fs.cwd().deleteFileZ(bin_path) catch {};
+        }
         if (options.asm_path != null and options.bin_path != null) {
             if (target_machine.emitToFile(module, &error_message, lowered_options)) {
                 defer llvm.disposeMessage(error_message);
@@ -1322,6 +1346,149 @@ pub const Object = struct {
             });
             return error.FailedToEmit;
         }
+
+        if (object_cache_digest) |digest| self.addCachedObject(digest, std.mem.span(options.bin_path.?), options);
+    }
+
+    /// Identifies the object file produced from `bitcode`, including everything
+    /// which is passed to LLVM besides the module itself.
+    fn objectCacheDigest(o: *Object, bitcode: []const u32, options: EmitOptions) Cache.HexDigest {
+        var hh: Cache.HashHelper = .{};
+        hh.addBytes(build_options.version);
+        hh.addBytes(std.mem.sliceAsBytes(bitcode));
+        o.addObjectCacheOptions(&hh, options);
+        return hh.final();
+    }
+
+    /// Identifies the output which `emit` writes an object for, that is
+    /// everything in `objectCacheDigest` except the bitcode. The cache keeps
+    /// only the object most recently emitted for each output.
+    fn objectCacheSlot(o: *Object, options: EmitOptions) Cache.HexDigest {
+        const comp = o.pt.zcu.comp;
+        var hh: Cache.HashHelper = .{};
+        hh.addBytes(build_options.version);
+        hh.addBytes(comp.root_name);
+        hh.addOptionalBytes(comp.root_mod.root.root_dir.path);
+        hh.addBytes(comp.root_mod.root.sub_path);
+        hh.addBytes(comp.root_mod.root_src_path);
+        o.addObjectCacheOptions(&hh, options);
+        return hh.final();
+    }
+
+    fn addObjectCacheOptions(o: *Object, hh: *Cache.HashHelper, options: EmitOptions) void {
+        const comp = o.pt.zcu.comp;
+        const resolved_target = comp.root_mod.resolved_target;
+        hh.addOptionalBytes(resolved_target.result.cpu.model.llvm_name);
+        hh.addOptionalBytes(if (resolved_target.llvm_cpu_features) |f| std.mem.span(f) else null);
+        hh.addOptionalBytes(target_util.llvmMachineAbi(resolved_target.result));
+        hh.add(comp.root_mod.optimize_mode);
+        hh.add(comp.root_mod.pic);
+        hh.add(comp.config.pie);
+        hh.add(comp.config.link_mode);
+        hh.add(comp.root_mod.code_model);
+        hh.add(comp.function_sections);
+        hh.add(comp.data_sections);
+        hh.add(comp.llvm_opt_bisect_limit);
+        hh.add(comp.config.san_cov_trace_pc_guard);
+        hh.add(options.is_debug);
+        hh.add(options.is_small);
+        hh.add(options.sanitize_thread);
+        hh.add(options.fuzz);
+        hh.add(options.lto);
+    }
+
+    /// Hard links (or, failing that, copies) the object file with `digest` from
+    /// the local cache to `bin_path`. Returns false when there is no such object.
+    fn copyCachedObject(o: *Object, digest: Cache.HexDigest, bin_path: []const u8, options: EmitOptions) bool {
+        const cache_dir = o.pt.zcu.comp.local_cache_directory.handle;
+        const sub_path = "o" ++ std.fs.path.sep_str ++ digest ++ std.fs.path.sep_str ++ cached_object_basename;
+        linkOrCopyFile(cache_dir, &sub_path, std.fs.cwd(), bin_path) catch |err| switch (err) {
+            error.FileNotFound => return false,
+            else => {
+                log.warn("unable to copy cached LLVM object '{s}': {s}", .{ sub_path, @errorName(err) });
+                return false;
+            },
+        };
+        log.debug("reused cached LLVM object '{s}'", .{sub_path});
+        o.setCachedObjectSlot(digest, options);
+        return true;
+    }
+
+    /// Stores the object file just emitted to `bin_path` in the local cache.
+    /// Failure only costs running LLVM again next time, so it is not an error.
+    fn addCachedObject(o: *Object, digest: Cache.HexDigest, bin_path: []const u8, options: EmitOptions) void {
+        const cache_dir = o.pt.zcu.comp.local_cache_directory.handle;
+        const sub_dir = "o" ++ std.fs.path.sep_str ++ digest;
+        var dir = cache_dir.makeOpenPath(&sub_dir, .{}) catch |err| {
+            log.warn("unable to create cached LLVM object directory '{s}': {s}", .{ sub_dir, @errorName(err) });
+            return;
+        };
+        defer dir.close();
+        linkOrCopyFile(std.fs.cwd(), bin_path, dir, cached_object_basename) catch |err| {
+            log.warn("unable to cache LLVM object '{s}': {s}", .{ bin_path, @errorName(err) });
+            return;
+        };
+        o.setCachedObjectSlot(digest, options);
+    }
+
+    /// Records `digest` as the cached object of the output identified by
+    /// `objectCacheSlot` and deletes the object recorded for it before. This
+    /// bounds the cache to one object per output instead of one per distinct
+    /// object ever emitted. A concurrent `copyCachedObject` of the deleted
+    /// object either completes first or finds no object and emits it again.
+    fn setCachedObjectSlot(o: *Object, digest: Cache.HexDigest, options: EmitOptions) void {
+        const cache_dir = o.pt.zcu.comp.local_cache_directory.handle;
+        const slot_path = "h" ++ std.fs.path.sep_str ++ o.objectCacheSlot(options) ++ ".llvm_object";
+
+        const prev_digest: ?Cache.HexDigest = prev: {
+            var buf: Cache.HexDigest = undefined;
+            const bytes = cache_dir.readFile(&slot_path, &buf) catch break :prev null;
+            if (bytes.len != buf.len) break :prev null;
+            for (buf) |c| if (!std.ascii.isHex(c)) break :prev null;
+            break :prev buf;
+        };
+        if (prev_digest) |prev| if (std.mem.eql(u8, &prev, &digest)) return;
+
+        var slot_file = cache_dir.atomicFile(&slot_path, .{}) catch |err| {
+            log.warn("unable to record cached LLVM object '{s}': {s}", .{ slot_path, @errorName(err) });
+            return;
+        };
+        defer slot_file.deinit();
+        slot_file.file.writeAll(&digest) catch |err| {
+            log.warn("unable to record cached LLVM object '{s}': {s}", .{ slot_path, @errorName(err) });
+            return;
+        };
+        slot_file.finish() catch |err| {
+            log.warn("unable to record cached LLVM object '{s}': {s}", .{ slot_path, @errorName(err) });
+            return;
+        };
+
+        const prev_sub_path = "o" ++ std.fs.path.sep_str ++ (prev_digest orelse return);
+        cache_dir.deleteTree(&prev_sub_path) catch |err| {
+            log.warn("unable to delete cached LLVM object '{s}': {s}", .{ prev_sub_path, @errorName(err) });
+        };
+    }
+
+    const cached_object_basename = "llvm.o";
+
+    /// Replaces `dest_path` with a hard link to `source_path`, so that reusing a
+    /// cached object does not copy it. Falls back to copying where hard links
+    /// are not available, such as on Windows or across file systems. `emit`
+    /// deletes the object before LLVM writes it, so a linked object is never
+    /// modified in place.
+    fn linkOrCopyFile(source_dir: std.fs.Dir, source_path: []const u8, dest_dir: std.fs.Dir, dest_path: []const u8) !void {
+        if (builtin.os.tag != .windows) link: {
+            dest_dir.deleteFile(dest_path) catch |err| switch (err) {
+                error.FileNotFound => {},
+                else => break :link,
+            };
+            std.posix.linkat(source_dir.fd, source_path, dest_dir.fd, dest_path, 0) catch |err| switch (err) {
+                error.FileNotFound => |e| return e,
+                else => break :link,
+            };
+            return;
+        }
+        try source_dir.copyFile(source_path, dest_dir, dest_path, .{});
     }
 
     pub fn updateFunc(
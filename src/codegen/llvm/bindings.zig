@@ -90,7 +90,7 @@ pub const TargetMachine = opaque {
         time_report: bool,
         tsan: bool,
         sancov: bool,
-        lto: bool,
+        lto: LtoMode,
         asm_filename: ?[*:0]const u8,
         bin_filename: ?[*:0]const u8,
         llvm_ir_filename: ?[*:0]const u8,
@@ -123,6 +123,12 @@ pub const TargetMachine = opaque {
                 Edge,
             };
         };
+
+        pub const LtoMode = enum(c_uint) {
+            None,
+            Full,
+            Thin,
+        };
     };
 
     pub const emitToFile = ZigLLVMTargetMachineEmitToFile;
@@ -329,6 +335,7 @@ extern fn ZigLLVMWriteArchive(
     file_names_ptr: [*]const [*:0]const u8,
     file_names_len: usize,
     os_type: OSType,
+    thin: bool,
 ) bool;
 
 pub const OSType = enum(c_int) {
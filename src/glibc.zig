@@ -12,6 +12,7 @@ const build_options = @import("build_options");
 const trace = @import("tracy.zig").trace;
 const Cache = std.Build.Cache;
 const Module = @import("Package/Module.zig");
+const stub_library = @import("link/Elf/stub_library.zig");
 
 pub const Lib = struct {
     name: []const u8,
@@ -680,7 +681,13 @@ pub fn buildSharedObjects(comp: *Compilation, prog_node: std.Progress.Node) !voi
     const tracy = trace(@src());
     defer tracy.end();
 
-    if (!build_options.have_llvm) {
+    const target = comp.getTarget();
+    const target_version = target.os.version_range.linux.glibc;
+
+    // Where possible, the stubs are written directly rather than assembled
+    // and linked by a sub-compilation for each library.
+    const direct_stubs = stub_library.isSupported(target);
+    if (!direct_stubs and !build_options.have_llvm) {
         return error.ZigCompilerNotBuiltWithLLVMExtensions;
     }
 
@@ -688,9 +695,6 @@ pub fn buildSharedObjects(comp: *Compilation, prog_node: std.Progress.Node) !voi
     defer arena_allocator.deinit();
     const arena = arena_allocator.allocator();
 
-    const target = comp.getTarget();
-    const target_version = target.os.version_range.linux.glibc;
-
     // Use the global cache directory.
     var cache: Cache = .{
         .gpa = comp.gpa,
@@ -707,6 +711,7 @@ pub fn buildSharedObjects(comp: *Compilation, prog_node: std.Progress.Node) !voi
     man.hash.add(target.cpu.arch);
     man.hash.add(target.abi);
     man.hash.add(target_version);
+    man.hash.add(direct_stubs);
 
     const full_abilists_path = try comp.zig_lib_directory.join(arena, &.{abilists_path});
     const abilists_index = try man.addFile(full_abilists_path, abilists_max_size);
@@ -764,56 +769,113 @@ pub fn buildSharedObjects(comp: *Compilation, prog_node: std.Progress.Node) !voi
         break :blk latest_index;
     };
 
-    {
-        var map_contents = std.ArrayList(u8).init(arena);
-        for (metadata.all_versions[0 .. target_ver_index + 1]) |ver| {
-            if (ver.patch == 0) {
-                try map_contents.writer().print("GLIBC_{d}.{d} {{ }};\n", .{ ver.major, ver.minor });
-            } else {
-                try map_contents.writer().print("GLIBC_{d}.{d}.{d} {{ }};\n", .{ ver.major, ver.minor, ver.patch });
+    const stubs = try collectStubs(arena, metadata, target_targ_index, target_ver_index);
+
+    if (direct_stubs) {
+        const versions = try arena.alloc([]const u8, target_ver_index + 1);
+        for (versions, metadata.all_versions[0..versions.len]) |*name, ver| {
+            name.* = try versionName(arena, ver);
+        }
+        for (libs, stubs) |lib, lib_stubs| {
+            const basename = try libBasename(arena, lib);
+            const file = try o_directory.handle.createFile(basename, .{});
+            defer file.close();
+            try stub_library.write(comp.gpa, file, .{
+                .soname = try libSoname(arena, target, lib, basename),
+                .machine = target.cpu.arch.toElfMachine(),
+                .endian = target.cpu.arch.endian(),
+                .versions = versions,
+                .symbols = lib_stubs,
+            });
+        }
+    } else {
+        {
+            var map_contents = std.ArrayList(u8).init(arena);
+            for (metadata.all_versions[0 .. target_ver_index + 1]) |ver| {
+                if (ver.patch == 0) {
+                    try map_contents.writer().print("GLIBC_{d}.{d} {{ }};\n", .{ ver.major, ver.minor });
+                } else {
+                    try map_contents.writer().print("GLIBC_{d}.{d}.{d} {{ }};\n", .{ ver.major, ver.minor, ver.patch });
+                }
             }
+            try o_directory.handle.writeFile(.{ .sub_path = all_map_basename, .data = map_contents.items });
+            map_contents.deinit(); // The most recent allocation of an arena can be freed :)
+        }
+
+        var stubs_asm = std.ArrayList(u8).init(comp.gpa);
+        defer stubs_asm.deinit();
+
+        for (libs, stubs) |lib, lib_stubs| {
+            stubs_asm.shrinkRetainingCapacity(0);
+            try writeStubsAsm(arena, stubs_asm.writer(), metadata, lib_stubs);
+
+            var lib_name_buf: [32]u8 = undefined; // Larger than each of the names "c", "pthread", etc.
+            const asm_file_basename = std.fmt.bufPrint(&lib_name_buf, "{s}.s", .{lib.name}) catch unreachable;
+            try o_directory.handle.writeFile(.{ .sub_path = asm_file_basename, .data = stubs_asm.items });
+
+            try buildSharedLib(comp, arena, comp.global_cache_directory, o_directory, asm_file_basename, lib, prog_node);
         }
-        try o_directory.handle.writeFile(.{ .sub_path = all_map_basename, .data = map_contents.items });
-        map_contents.deinit(); // The most recent allocation of an arena can be freed :)
     }
 
-    var stubs_asm = std.ArrayList(u8).init(comp.gpa);
-    defer stubs_asm.deinit();
+    man.writeManifest() catch |err| {
+        log.warn("failed to write cache manifest for glibc stubs: {s}", .{@errorName(err)});
+    };
 
-    for (libs, 0..) |lib, lib_i| {
-        stubs_asm.shrinkRetainingCapacity(0);
-        try stubs_asm.appendSlice(".text\n");
+    assert(comp.glibc_so_files == null);
+    comp.glibc_so_files = BuiltSharedObjects{
+        .lock = man.toOwnedLock(),
+        .dir_path = try comp.global_cache_directory.join(comp.gpa, &.{ "o", &digest }),
+    };
+}
 
-        var inc_i: usize = 0;
+// zig fmt: on
 
-        const fn_inclusions_len = mem.readInt(u16, metadata.inclusions[inc_i..][0..2], .little);
+/// Extracts the symbols of every library for one target and glibc version in
+/// a single pass over `ABI.inclusions`. Each symbol is listed once for every
+/// version which applies to it.
+fn collectStubs(
+    arena: Allocator,
+    metadata: *const ABI,
+    target_targ_index: usize,
+    target_ver_index: usize,
+) ![libs.len][]const stub_library.Symbol {
+    var stubs: [libs.len]std.ArrayListUnmanaged(stub_library.Symbol) = .{.{}} ** libs.len;
+    var inc_i: usize = 0;
+
+    // Functions come first, followed by objects, which also have a size.
+    for ([_]bool{ false, true }) |is_object| {
+        const inclusions_len = mem.readInt(u16, metadata.inclusions[inc_i..][0..2], .little);
         inc_i += 2;
 
         var sym_i: usize = 0;
         var opt_symbol_name: ?[]const u8 = null;
-        var versions_buffer: [32]u8 = undefined;
-        var versions_len: usize = undefined;
-        while (sym_i < fn_inclusions_len) : (sym_i += 1) {
+        // The versions of the current symbol in each library.
+        var versions: [libs.len]std.BoundedArray(u7, 32) = undefined;
+        while (sym_i < inclusions_len) : (sym_i += 1) {
             const sym_name = opt_symbol_name orelse n: {
                 const name = mem.sliceTo(metadata.inclusions[inc_i..], 0);
                 inc_i += name.len + 1;
 
                 opt_symbol_name = name;
-                versions_buffer = undefined;
-                versions_len = 0;
+                for (&versions) |*lib_versions| lib_versions.len = 0;
                 break :n name;
             };
             const targets = mem.readInt(u32, metadata.inclusions[inc_i..][0..4], .little);
             inc_i += 4;
 
+            const size: ?u16 = if (is_object) size: {
+                defer inc_i += 2;
+                break :size mem.readInt(u16, metadata.inclusions[inc_i..][0..2], .little);
+            } else null;
+
             const lib_index = metadata.inclusions[inc_i];
             inc_i += 1;
             const is_terminal = (targets & (1 << 31)) != 0;
             if (is_terminal) opt_symbol_name = null;
 
-            // Test whether the inclusion applies to our current library and target.
+            // Test whether the inclusion applies to our current target.
             const ok_lib_and_target =
-                (lib_index == lib_i) and
+                (lib_index < libs.len) and
                 ((targets & (@as(u32, 1) << @as(u5, @intCast(target_targ_index)))) != 0);
 
             while (true) {
@@ -822,259 +884,105 @@ pub fn buildSharedObjects(comp: *Compilation, prog_node: std.Progress.Node) !voi
                 const last = (byte & 0b1000_0000) != 0;
                 const ver_i = @as(u7, @truncate(byte));
                 if (ok_lib_and_target and ver_i <= target_ver_index) {
-                    versions_buffer[versions_len] = ver_i;
-                    versions_len += 1;
+                    versions[lib_index].appendAssumeCapacity(ver_i);
                 }
                 if (last) break;
             }
 
             if (!is_terminal) continue;
 
-            // Pick the default symbol version:
-            // - If there are no versions, don't emit it
-            // - Take the greatest one <= than the target one
-            // - If none of them is <= than the
-            //   specified one don't pick any default version
-            if (versions_len == 0) continue;
-            var chosen_def_ver_index: u8 = 255;
-            {
-                var ver_buf_i: u8 = 0;
-                while (ver_buf_i < versions_len) : (ver_buf_i += 1) {
-                    const ver_index = versions_buffer[ver_buf_i];
-                    if (chosen_def_ver_index == 255 or ver_index > chosen_def_ver_index) {
-                        chosen_def_ver_index = ver_index;
-                    }
-                }
-            }
-            {
-                var ver_buf_i: u8 = 0;
-                while (ver_buf_i < versions_len) : (ver_buf_i += 1) {
-                    // Example:
-                    // .globl _Exit_2_2_5
-                    // .type _Exit_2_2_5, %function;
-                    // .symver _Exit_2_2_5, _Exit@@GLIBC_2.2.5
-                    // _Exit_2_2_5:
-                    const ver_index = versions_buffer[ver_buf_i];
-                    const ver = metadata.all_versions[ver_index];
-                    // Default symbol version definition vs normal symbol version definition
-                    const want_default = chosen_def_ver_index != 255 and ver_index == chosen_def_ver_index;
-                    const at_sign_str: []const u8 = if (want_default) "@@" else "@";
-                    if (ver.patch == 0) {
-                        const sym_plus_ver = if (want_default)
-                            sym_name
-                        else
-                            try std.fmt.allocPrint(
-                                arena,
-                                "{s}_GLIBC_{d}_{d}",
-                                .{ sym_name, ver.major, ver.minor },
-                            );
-                        try stubs_asm.writer().print(
-                            \\.globl {s}
-                            \\.type {s}, %function;
-                            \\.symver {s}, {s}{s}GLIBC_{d}.{d}
-                            \\{s}:
-                            \\
-                        , .{
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            sym_name,
-                            at_sign_str,
-                            ver.major,
-                            ver.minor,
-                            sym_plus_ver,
-                        });
-                    } else {
-                        const sym_plus_ver = if (want_default)
-                            sym_name
-                        else
-                            try std.fmt.allocPrint(
-                                arena,
-                                "{s}_GLIBC_{d}_{d}_{d}",
-                                .{ sym_name, ver.major, ver.minor, ver.patch },
-                            );
-                        try stubs_asm.writer().print(
-                            \\.globl {s}
-                            \\.type {s}, %function;
-                            \\.symver {s}, {s}{s}GLIBC_{d}.{d}.{d}
-                            \\{s}:
-                            \\
-                        , .{
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            sym_name,
-                            at_sign_str,
-                            ver.major,
-                            ver.minor,
-                            ver.patch,
-                            sym_plus_ver,
-                        });
-                    }
+            for (&stubs, &versions) |*lib_stubs, lib_versions| {
+                // Pick the default symbol version:
+                // - If there are no versions, don't emit it
+                // - Take the greatest one <= than the target one
+                if (lib_versions.len == 0) continue;
+                const default_ver_index = mem.max(u7, lib_versions.slice());
+                for (lib_versions.slice()) |ver_index| {
+                    try lib_stubs.append(arena, .{
+                        .name = sym_name,
+                        .version = ver_index,
+                        .is_default = ver_index == default_ver_index,
+                        .object_size = size,
+                    });
                 }
             }
         }
+    }
 
-        try stubs_asm.appendSlice(".data\n");
-
-        const obj_inclusions_len = mem.readInt(u16, metadata.inclusions[inc_i..][0..2], .little);
-        inc_i += 2;
+    var result: [libs.len][]const stub_library.Symbol = undefined;
+    for (&result, stubs) |*lib_result, lib_stubs| lib_result.* = lib_stubs.items;
+    return result;
+}
 
-        sym_i = 0;
-        opt_symbol_name = null;
-        versions_buffer = undefined;
-        versions_len = undefined;
-        while (sym_i < obj_inclusions_len) : (sym_i += 1) {
-            const sym_name = opt_symbol_name orelse n: {
-                const name = mem.sliceTo(metadata.inclusions[inc_i..], 0);
-                inc_i += name.len + 1;
+fn versionName(arena: Allocator, ver: Version) ![]const u8 {
+    return if (ver.patch == 0)
+        std.fmt.allocPrint(arena, "GLIBC_{d}.{d}", .{ ver.major, ver.minor })
+    else
+        std.fmt.allocPrint(arena, "GLIBC_{d}.{d}.{d}", .{ ver.major, ver.minor, ver.patch });
+}
 
-                opt_symbol_name = name;
-                versions_buffer = undefined;
-                versions_len = 0;
-                break :n name;
+/// Writes the assembly for the stub library of `lib`, which `buildSharedLib`
+/// turns into a shared object.
+fn writeStubsAsm(
+    arena: Allocator,
+    writer: anytype,
+    metadata: *const ABI,
+    stubs: []const stub_library.Symbol,
+) !void {
+    for ([_]bool{ false, true }) |is_object| {
+        try writer.writeAll(if (is_object) ".data\n" else ".text\n");
+        for (stubs) |stub| {
+            if ((stub.object_size != null) != is_object) continue;
+            const ver_name = try versionName(arena, metadata.all_versions[stub.version]);
+            // Default symbol version definition vs normal symbol version definition
+            const at_sign_str: []const u8 = if (stub.is_default) "@@" else "@";
+            const sym_plus_ver = if (stub.is_default) stub.name else sym: {
+                const sym = try std.fmt.allocPrint(arena, "{s}_{s}", .{ stub.name, ver_name });
+                mem.replaceScalar(u8, sym[stub.name.len + 1 ..], '.', '_');
+                break :sym sym;
             };
-            const targets = mem.readInt(u32, metadata.inclusions[inc_i..][0..4], .little);
-            inc_i += 4;
-
-            const size = mem.readInt(u16, metadata.inclusions[inc_i..][0..2], .little);
-            inc_i += 2;
-
-            const lib_index = metadata.inclusions[inc_i];
-            inc_i += 1;
-            const is_terminal = (targets & (1 << 31)) != 0;
-            if (is_terminal) opt_symbol_name = null;
-
-            // Test whether the inclusion applies to our current library and target.
-            const ok_lib_and_target =
-                (lib_index == lib_i) and
-                ((targets & (@as(u32, 1) << @as(u5, @intCast(target_targ_index)))) != 0);
-
-            while (true) {
-                const byte = metadata.inclusions[inc_i];
-                inc_i += 1;
-                const last = (byte & 0b1000_0000) != 0;
-                const ver_i = @as(u7, @truncate(byte));
-                if (ok_lib_and_target and ver_i <= target_ver_index) {
-                    versions_buffer[versions_len] = ver_i;
-                    versions_len += 1;
-                }
-                if (last) break;
-            }
-
-            if (!is_terminal) continue;
-
-            // Pick the default symbol version:
-            // - If there are no versions, don't emit it
-            // - Take the greatest one <= than the target one
-            // - If none of them is <= than the
-            //   specified one don't pick any default version
-            if (versions_len == 0) continue;
-            var chosen_def_ver_index: u8 = 255;
-            {
-                var ver_buf_i: u8 = 0;
-                while (ver_buf_i < versions_len) : (ver_buf_i += 1) {
-                    const ver_index = versions_buffer[ver_buf_i];
-                    if (chosen_def_ver_index == 255 or ver_index > chosen_def_ver_index) {
-                        chosen_def_ver_index = ver_index;
-                    }
-                }
-            }
-            {
-                var ver_buf_i: u8 = 0;
-                while (ver_buf_i < versions_len) : (ver_buf_i += 1) {
-                    // Example:
-                    // .globl environ_2_2_5
-                    // .type environ_2_2_5, %object;
-                    // .size environ_2_2_5, 4;
-                    // .symver environ_2_2_5, environ@@GLIBC_2.2.5
-                    // environ_2_2_5:
-                    const ver_index = versions_buffer[ver_buf_i];
-                    const ver = metadata.all_versions[ver_index];
-                    // Default symbol version definition vs normal symbol version definition
-                    const want_default = chosen_def_ver_index != 255 and ver_index == chosen_def_ver_index;
-                    const at_sign_str: []const u8 = if (want_default) "@@" else "@";
-                    if (ver.patch == 0) {
-                        const sym_plus_ver = if (want_default)
-                            sym_name
-                        else
-                            try std.fmt.allocPrint(
-                                arena,
-                                "{s}_GLIBC_{d}_{d}",
-                                .{ sym_name, ver.major, ver.minor },
-                            );
-                        try stubs_asm.writer().print(
-                            \\.globl {s}
-                            \\.type {s}, %object;
-                            \\.size {s}, {d};
-                            \\.symver {s}, {s}{s}GLIBC_{d}.{d}
-                            \\{s}:
-                            \\
-                        , .{
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            size,
-                            sym_plus_ver,
-                            sym_name,
-                            at_sign_str,
-                            ver.major,
-                            ver.minor,
-                            sym_plus_ver,
-                        });
-                    } else {
-                        const sym_plus_ver = if (want_default)
-                            sym_name
-                        else
-                            try std.fmt.allocPrint(
-                                arena,
-                                "{s}_GLIBC_{d}_{d}_{d}",
-                                .{ sym_name, ver.major, ver.minor, ver.patch },
-                            );
-                        try stubs_asm.writer().print(
-                            \\.globl {s}
-                            \\.type {s}, %object;
-                            \\.size {s}, {d};
-                            \\.symver {s}, {s}{s}GLIBC_{d}.{d}.{d}
-                            \\{s}:
-                            \\
-                        , .{
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            sym_plus_ver,
-                            size,
-                            sym_plus_ver,
-                            sym_name,
-                            at_sign_str,
-                            ver.major,
-                            ver.minor,
-                            ver.patch,
-                            sym_plus_ver,
-                        });
-                    }
-                }
+            if (stub.object_size) |size| {
+                // Example:
+                // .globl environ_GLIBC_2_2_5
+                // .type environ_GLIBC_2_2_5, %object;
+                // .size environ_GLIBC_2_2_5, 4;
+                // .symver environ_GLIBC_2_2_5, environ@GLIBC_2.2.5
+                // environ_GLIBC_2_2_5:
+                try writer.print(
+                    \\.globl {s}
+                    \\.type {s}, %object;
+                    \\.size {s}, {d};
+                    \\.symver {s}, {s}{s}{s}
+                    \\{s}:
+                    \\
+                , .{ sym_plus_ver, sym_plus_ver, sym_plus_ver, size, sym_plus_ver, stub.name, at_sign_str, ver_name, sym_plus_ver });
+            } else {
+                // Example:
+                // .globl _Exit_GLIBC_2_2_5
+                // .type _Exit_GLIBC_2_2_5, %function;
+                // .symver _Exit_GLIBC_2_2_5, _Exit@GLIBC_2.2.5
+                // _Exit_GLIBC_2_2_5:
+                try writer.print(
+                    \\.globl {s}
+                    \\.type {s}, %function;
+                    \\.symver {s}, {s}{s}{s}
+                    \\{s}:
+                    \\
+                , .{ sym_plus_ver, sym_plus_ver, sym_plus_ver, stub.name, at_sign_str, ver_name, sym_plus_ver });
             }
         }
-
-        var lib_name_buf: [32]u8 = undefined; // Larger than each of the names "c", "pthread", etc.
-        const asm_file_basename = std.fmt.bufPrint(&lib_name_buf, "{s}.s", .{lib.name}) catch unreachable;
-        try o_directory.handle.writeFile(.{ .sub_path = asm_file_basename, .data = stubs_asm.items });
-
-        try buildSharedLib(comp, arena, comp.global_cache_directory, o_directory, asm_file_basename, lib, prog_node);
     }
+}
 
-    man.writeManifest() catch |err| {
-        log.warn("failed to write cache manifest for glibc stubs: {s}", .{@errorName(err)});
-    };
-
-    assert(comp.glibc_so_files == null);
-    comp.glibc_so_files = BuiltSharedObjects{
-        .lock = man.toOwnedLock(),
-        .dir_path = try comp.global_cache_directory.join(comp.gpa, &.{ "o", &digest }),
-    };
+fn libBasename(arena: Allocator, lib: Lib) ![]const u8 {
+    return std.fmt.allocPrint(arena, "lib{s}.so.{d}", .{ lib.name, lib.sover });
 }
 
-// zig fmt: on
+fn libSoname(arena: Allocator, target: std.Target, lib: Lib, basename: []const u8) ![]const u8 {
+    if (!mem.eql(u8, lib.name, "ld")) return basename;
+    const dynamic_linker = target.standardDynamicLinkerPath();
+    return arena.dupe(u8, path.basename(dynamic_linker.get().?));
+}
 
 fn buildSharedLib(
     comp: *Compilation,
@@ -1088,14 +996,13 @@ fn buildSharedLib(
     const tracy = trace(@src());
     defer tracy.end();
 
-    const basename = try std.fmt.allocPrint(arena, "lib{s}.so.{d}", .{ lib.name, lib.sover });
+    const basename = try libBasename(arena, lib);
     const emit_bin = Compilation.EmitLoc{
         .directory = bin_directory,
         .basename = basename,
     };
     const version: Version = .{ .major = lib.sover, .minor = 0, .patch = 0 };
-    const ld_basename = path.basename(comp.getTarget().standardDynamicLinkerPath().get().?);
-    const soname = if (mem.eql(u8, lib.name, "ld")) ld_basename else basename;
+    const soname = try libSoname(arena, comp.getTarget(), lib, basename);
     const map_file_path = try path.join(arena, &.{ bin_directory.path.?, all_map_basename });
 
     const optimize_mode = comp.compilerRtOptMode();
@@ -1159,6 +1066,7 @@ fn buildSharedLib(
         .libc_installation = comp.libc_installation,
         .emit_bin = emit_bin,
         .emit_h = null,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
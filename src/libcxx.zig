@@ -316,6 +316,8 @@ pub fn buildLibCXX(comp: *Compilation, prog_node: std.Progress.Node) BuildError!
         .zig_lib_directory = comp.zig_lib_directory,
         .self_exe_path = comp.self_exe_path,
         .cache_mode = .whole,
+        .runtime_store = comp.runtime_store,
+        .use_runtime_store = true,
         .config = config,
         .root_mod = root_mod,
         .root_name = root_name,
@@ -324,6 +326,7 @@ pub fn buildLibCXX(comp: *Compilation, prog_node: std.Progress.Node) BuildError!
         .emit_bin = emit_bin,
         .emit_h = null,
         .c_source_files = c_source_files.items,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
@@ -546,6 +549,8 @@ pub fn buildLibCXXABI(comp: *Compilation, prog_node: std.Progress.Node) BuildErr
         .zig_lib_directory = comp.zig_lib_directory,
         .self_exe_path = comp.self_exe_path,
         .cache_mode = .whole,
+        .runtime_store = comp.runtime_store,
+        .use_runtime_store = true,
         .config = config,
         .root_mod = root_mod,
         .root_name = root_name,
@@ -554,6 +559,7 @@ pub fn buildLibCXXABI(comp: *Compilation, prog_node: std.Progress.Node) BuildErr
         .emit_bin = emit_bin,
         .emit_h = null,
         .c_source_files = c_source_files.items,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
@@ -305,6 +305,7 @@ pub fn buildTsan(comp: *Compilation, prog_node: std.Progress.Node) BuildError!vo
         .emit_bin = emit_bin,
         .emit_h = null,
         .c_source_files = c_source_files.items,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
@@ -37,7 +37,7 @@ pub fn buildStaticLib(comp: *Compilation, prog_node: std.Progress.Node) BuildErr
         .root_strip = comp.compilerRtStrip(),
         .link_libc = true,
         // Disable LTO to avoid https://github.com/llvm/llvm-project/issues/56825
-        .lto = false,
+        .lto = .none,
     }) catch |err| {
         comp.setMiscFailure(
             .libunwind,
@@ -152,6 +152,8 @@ pub fn buildStaticLib(comp: *Compilation, prog_node: std.Progress.Node) BuildErr
         .config = config,
         .root_mod = root_mod,
         .cache_mode = .whole,
+        .runtime_store = comp.runtime_store,
+        .use_runtime_store = true,
         .root_name = root_name,
         .main_mod = null,
         .thread_pool = comp.thread_pool,
@@ -159,6 +161,7 @@ pub fn buildStaticLib(comp: *Compilation, prog_node: std.Progress.Node) BuildErr
         .emit_bin = emit_bin,
         .function_sections = comp.function_sections,
         .c_source_files = &c_source_files,
+        .clang_in_process = comp.clang_in_process,
         .verbose_cc = comp.verbose_cc,
         .verbose_link = comp.verbose_link,
         .verbose_air = comp.verbose_air,
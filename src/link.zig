@@ -22,6 +22,7 @@ const LlvmObject = @import("codegen/llvm.zig").Object;
 const lldMain = @import("main.zig").lldMain;
 const Package = @import("Package.zig");
 const dev = @import("dev.zig");
+const archiver = @import("link/archiver.zig");
 
 /// When adding a new field, remember to update `hashAddSystemLibs`.
 /// These are *always* dynamically linked. Static libraries will be
@@ -602,11 +603,15 @@ pub const File = struct {
         const output_mode = comp.config.output_mode;
         const link_mode = comp.config.link_mode;
         if (use_lld and output_mode == .Lib and link_mode == .static) {
+            const time_trace_span = comp.timeTraceBegin(.link, "archive");
+            defer time_trace_span.end();
             return base.linkAsArchive(arena, tid, prog_node);
         }
         switch (base.tag) {
             inline else => |tag| {
                 dev.check(tag.devFeature());
+                const time_trace_span = comp.timeTraceBegin(.link, "flush " ++ @tagName(tag));
+                defer time_trace_span.end();
                 return @as(*tag.Type(), @fieldParentPtr("base", base)).flush(arena, tid, prog_node);
             },
         }
@@ -790,6 +795,7 @@ pub const File = struct {
             }
             try man.addOptionalFile(zcu_obj_path);
             try man.addOptionalFile(compiler_rt_path);
+            man.hash.add(comp.thin_archive);
 
             // We don't actually care whether it's a cache hit or miss; we just need the digest and the lock.
             _ = try man.hit();
@@ -819,40 +825,69 @@ pub const File = struct {
 
         const win32_resource_table_len = comp.win32_resource_table.count();
         const num_object_files = objects.len + comp.c_object_table.count() + win32_resource_table_len + 2;
-        var object_files = try std.ArrayList([*:0]const u8).initCapacity(gpa, num_object_files);
+        var object_files = try std.ArrayList([]const u8).initCapacity(gpa, num_object_files);
         defer object_files.deinit();
 
         for (objects) |obj| {
-            object_files.appendAssumeCapacity(try arena.dupeZ(u8, obj.path));
+            object_files.appendAssumeCapacity(obj.path);
         }
         for (comp.c_object_table.keys()) |key| {
-            object_files.appendAssumeCapacity(try arena.dupeZ(u8, key.status.success.object_path));
+            object_files.appendAssumeCapacity(key.status.success.object_path);
         }
         for (comp.win32_resource_table.keys()) |key| {
-            object_files.appendAssumeCapacity(try arena.dupeZ(u8, key.status.success.res_path));
+            object_files.appendAssumeCapacity(key.status.success.res_path);
         }
         if (zcu_obj_path) |p| {
-            object_files.appendAssumeCapacity(try arena.dupeZ(u8, p));
+            object_files.appendAssumeCapacity(p);
         }
         if (compiler_rt_path) |p| {
-            object_files.appendAssumeCapacity(try arena.dupeZ(u8, p));
+            object_files.appendAssumeCapacity(p);
         }
 
         if (comp.verbose_link) {
-            std.debug.print("ar rcs {s}", .{full_out_path_z});
+            std.debug.print("ar {s} {s}", .{ if (comp.thin_archive) "rcsT" else "rcs", full_out_path_z });
             for (object_files.items) |arg| {
                 std.debug.print(" {s}", .{arg});
             }
             std.debug.print("\n", .{});
         }
 
-        const llvm_bindings = @import("codegen/llvm/bindings.zig");
-        const llvm = @import("codegen/llvm.zig");
+        // LLVM picks the BSD format for these, and bitcode members (LTO) need
+        // LLVM to find their symbols, so those still go through `WriteArchive`.
         const target = comp.root_mod.resolved_target.result;
-        llvm.initializeLLVMTarget(target.cpu.arch);
-        const os_tag = llvm.targetOs(target.os.tag);
-        const bad = llvm_bindings.WriteArchive(full_out_path_z, object_files.items.ptr, object_files.items.len, os_tag);
-        if (bad) return error.UnableToWriteArchive;
+        const native = target.ofmt == .elf and switch (target.os.tag) {
+            .freebsd, .openbsd => false,
+            else => true,
+        };
+        // The output directory is a fresh temporary one in whole cache mode, so
+        // the symbol cache is kept in the local cache directory instead, under a
+        // name which stays the same when the archive's contents change.
+        const symbol_cache_sub_path = try std.fmt.allocPrint(arena, "h/ar-symbols-{x:0>16}", .{
+            std.hash.Wyhash.hash(0, try mem.concat(arena, u8, &.{
+                fs.path.basename(base.emit.sub_path), "\x00", try target.zigTriple(arena),
+            })),
+        });
+        const wrote_natively = native and if (archiver.writeGnu(gpa, comp.thread_pool, directory.handle, base.emit.sub_path, object_files.items, .{
+            .thin = comp.thin_archive,
+            .symbol_cache = .{ .dir = comp.local_cache_directory.handle, .sub_path = symbol_cache_sub_path },
+        })) true else |err| switch (err) {
+            error.UnsupportedMember => false,
+            error.OutOfMemory => return error.OutOfMemory,
+            else => |e| {
+                log.err("unable to write archive '{s}': {s}", .{ full_out_path, @errorName(e) });
+                return error.UnableToWriteArchive;
+            },
+        };
+        if (!wrote_natively) {
+            const llvm_bindings = @import("codegen/llvm/bindings.zig");
+            const llvm = @import("codegen/llvm.zig");
+            llvm.initializeLLVMTarget(target.cpu.arch);
+            const os_tag = llvm.targetOs(target.os.tag);
+            const file_names = try arena.alloc([*:0]const u8, object_files.items.len);
+            for (file_names, object_files.items) |*file_name, object_file| file_name.* = try arena.dupeZ(u8, object_file);
+            const bad = llvm_bindings.WriteArchive(full_out_path_z, file_names.ptr, file_names.len, os_tag, comp.thin_archive);
+            if (bad) return error.UnableToWriteArchive;
+        }
 
         if (!base.disable_lld_caching) {
             Cache.writeSmallFile(directory.handle, id_symlink_basename, &digest) catch |err| {
@@ -1042,6 +1077,9 @@ pub fn spawnLld(
         Compilation.dump_argv(argv[1..]);
     }
 
+    const time_trace_span = comp.timeTraceBegin(.link, "lld");
+    defer time_trace_span.end();
+
     // If possible, we run LLD as a child process because it does not always
     // behave properly as a library, unfortunately.
     // https://github.com/ziglang/zig/issues/3825
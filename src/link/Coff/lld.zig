@@ -192,13 +192,19 @@ pub fn linkWithLLD(self: *Coff, arena: Allocator, tid: Zcu.PerThread.Id, prog_no
         if (comp.version) |version| {
             try argv.append(try allocPrint(arena, "-VERSION:{}.{}", .{ version.major, version.minor }));
         }
-        if (comp.config.lto) {
+        if (comp.config.lto != .none) {
             switch (optimize_mode) {
                 .Debug => {},
                 .ReleaseSmall => try argv.append("-OPT:lldlto=2"),
                 .ReleaseFast, .ReleaseSafe => try argv.append("-OPT:lldlto=3"),
             }
         }
+        if (comp.config.lto == .thin) {
+            try argv.append(try allocPrint(arena, "-OPT:lldltojobs={d}", .{comp.thread_pool.getIdCount()}));
+            try argv.append(try allocPrint(arena, "-LLDLTOCACHE:{s}", .{
+                try comp.global_cache_directory.join(arena, &.{"thinlto"}),
+            }));
+        }
         if (comp.config.output_mode == .Exe) {
             try argv.append(try allocPrint(arena, "-STACK:{d}", .{self.base.stack_size}));
         }
@@ -2234,7 +2234,7 @@ fn linkWithLLD(self: *Elf, arena: Allocator, tid: Zcu.PerThread.Id, prog_node: s
     // However, because LLD wants to resolve BPF relocations which it shouldn't, it fails
     // before even generating the relocatable.
     if (output_mode == .Obj and
-        (comp.config.lto or target.isBpfFreestanding()))
+        (comp.config.lto != .none or target.isBpfFreestanding()))
     {
         // In this case we must do a simple file copy
         // here. TODO: think carefully about how we can avoid this redundant operation when doing
@@ -2277,13 +2277,19 @@ fn linkWithLLD(self: *Elf, arena: Allocator, tid: Zcu.PerThread.Id, prog_node: s
             try argv.append(try std.fmt.allocPrint(arena, "--sysroot={s}", .{sysroot}));
         }
 
-        if (comp.config.lto) {
+        if (comp.config.lto != .none) {
             switch (comp.root_mod.optimize_mode) {
                 .Debug => {},
                 .ReleaseSmall => try argv.append("--lto-O2"),
                 .ReleaseFast, .ReleaseSafe => try argv.append("--lto-O3"),
             }
         }
+        if (comp.config.lto == .thin) {
+            try argv.append(try std.fmt.allocPrint(arena, "--thinlto-jobs={d}", .{comp.thread_pool.getIdCount()}));
+            try argv.append(try std.fmt.allocPrint(arena, "--thinlto-cache-dir={s}", .{
+                try comp.global_cache_directory.join(arena, &.{"thinlto"}),
+            }));
+        }
         switch (comp.root_mod.optimize_mode) {
             .Debug => {},
             .ReleaseSmall => try argv.append("-O2"),
@@ -0,0 +1,436 @@
+//! Writes shared objects which only define versioned dynamic symbols, such as
+//! the glibc stub libraries that programs are linked against in place of the
+//! real glibc. The result has just enough structure for a linker: a dynamic
+//! symbol table with symbol versions, a dynamic section with the soname, and
+//! program headers telling writable data apart from code. Symbols have no
+//! contents, so none of this is meant to be loaded at runtime.
+
+pub const Symbol = struct {
+    name: []const u8,
+    /// Index into `Options.versions`.
+    version: u16,
+    /// Whether this is the default version of the symbol (`name@@VERSION`),
+    /// which new code links against, rather than a compatibility version
+    /// (`name@VERSION`).
+    is_default: bool,
+    /// `null` for functions.
+    object_size: ?u16,
+};
+
+pub const Options = struct {
+    soname: []const u8,
+    machine: elf.EM,
+    endian: std.builtin.Endian,
+    /// Names of the version definitions, e.g. "GLIBC_2.2.5".
+    versions: []const []const u8,
+    symbols: []const Symbol,
+};
+
+/// Whether `write` can produce stub libraries for `target`. Architectures
+/// which encode their ABI in `e_flags` are left to the assembler.
+pub fn isSupported(target: std.Target) bool {
+    if (target.ptrBitWidth() != 64) return false;
+    return switch (target.cpu.arch) {
+        .x86_64, .aarch64, .aarch64_be, .s390x => true,
+        else => false,
+    };
+}
+
+const segment_align = 0x10000;
+const data_align = 16;
+
+const SectionIndex = enum(u16) {
+    null,
+    dynsym,
+    dynstr,
+    versym,
+    verdef,
+    text,
+    dynamic,
+    data,
+    shstrtab,
+};
+
+pub fn write(gpa: Allocator, file: std.fs.File, options: Options) !void {
+    var dynstr = std.ArrayList(u8).init(gpa);
+    defer dynstr.deinit();
+    var dynstr_offsets = std.StringHashMap(u32).init(gpa);
+    defer dynstr_offsets.deinit();
+    try dynstr.append(0);
+
+    const soname_offset = try addString(&dynstr, &dynstr_offsets, options.soname);
+    const version_offsets = try gpa.alloc(u32, options.versions.len);
+    defer gpa.free(version_offsets);
+    for (version_offsets, options.versions) |*offset, name| {
+        offset.* = try addString(&dynstr, &dynstr_offsets, name);
+    }
+    const name_offsets = try gpa.alloc(u32, options.symbols.len);
+    defer gpa.free(name_offsets);
+    for (name_offsets, options.symbols) |*offset, sym| {
+        offset.* = try addString(&dynstr, &dynstr_offsets, sym.name);
+    }
+
+    const shstrtab = "\x00.dynsym\x00.dynstr\x00.gnu.version\x00.gnu.version_d\x00.text\x00.dynamic\x00.data\x00.shstrtab\x00";
+
+    // Read-only segment, starting with the headers.
+    const phnum = 3;
+    const dynsym_offset = @sizeOf(elf.Elf64_Ehdr) + phnum * @sizeOf(elf.Elf64_Phdr);
+    const dynsym_size = (options.symbols.len + 1) * @sizeOf(elf.Elf64_Sym);
+    const dynstr_offset = dynsym_offset + dynsym_size;
+    const versym_offset = mem.alignForward(usize, dynstr_offset + dynstr.items.len, 2);
+    const versym_size = (options.symbols.len + 1) * @sizeOf(elf.Elf64_Versym);
+    const verdef_offset = mem.alignForward(usize, versym_offset + versym_size, 4);
+    const verdef_entry_size = @sizeOf(elf.Elf64_Verdef) + @sizeOf(elf.Elf64_Verdaux);
+    const verdef_size = (options.versions.len + 1) * verdef_entry_size;
+    const text_offset = mem.alignForward(usize, verdef_offset + verdef_size, data_align);
+
+    // Writable segment. Addresses are congruent to file offsets modulo the
+    // segment alignment, as the ELF specification requires.
+    const dynamic_offset = text_offset;
+    const dynamic_entries = 9;
+    const dynamic_size = dynamic_entries * @sizeOf(elf.Elf64_Dyn);
+    const dynamic_addr = mem.alignForward(usize, text_offset, segment_align) + dynamic_offset % segment_align;
+    const data_addr = mem.alignForward(usize, dynamic_addr + dynamic_size, data_align);
+    var data_size: usize = 0;
+    for (options.symbols) |sym| {
+        const size = sym.object_size orelse continue;
+        data_size += mem.alignForward(usize, @max(size, 1), data_align);
+    }
+
+    const shstrtab_offset = dynamic_offset + dynamic_size;
+    const shoff = mem.alignForward(usize, shstrtab_offset + shstrtab.len, 8);
+    const shnum = @typeInfo(SectionIndex).Enum.fields.len;
+    const file_size = shoff + shnum * @sizeOf(elf.Elf64_Shdr);
+
+    var buffer = try std.ArrayList(u8).initCapacity(gpa, file_size);
+    defer buffer.deinit();
+    const writer = buffer.writer();
+    const endian = options.endian;
+
+    var e_ident = [_]u8{0} ** elf.EI_NIDENT;
+    @memcpy(e_ident[0..elf.MAGIC.len], elf.MAGIC);
+    e_ident[elf.EI_CLASS] = elf.ELFCLASS64;
+    e_ident[elf.EI_DATA] = switch (endian) {
+        .little => elf.ELFDATA2LSB,
+        .big => elf.ELFDATA2MSB,
+    };
+    e_ident[elf.EI_VERSION] = 1;
+    try writeStruct(writer, elf.Elf64_Ehdr{
+        .e_ident = e_ident,
+        .e_type = .DYN,
+        .e_machine = options.machine,
+        .e_version = 1,
+        .e_entry = 0,
+        .e_phoff = @sizeOf(elf.Elf64_Ehdr),
+        .e_shoff = shoff,
+        .e_flags = 0,
+        .e_ehsize = @sizeOf(elf.Elf64_Ehdr),
+        .e_phentsize = @sizeOf(elf.Elf64_Phdr),
+        .e_phnum = phnum,
+        .e_shentsize = @sizeOf(elf.Elf64_Shdr),
+        .e_shnum = shnum,
+        .e_shstrndx = @intFromEnum(SectionIndex.shstrtab),
+    }, endian);
+
+    try writeStruct(writer, elf.Elf64_Phdr{
+        .p_type = elf.PT_LOAD,
+        .p_flags = elf.PF_R | elf.PF_X,
+        .p_offset = 0,
+        .p_vaddr = 0,
+        .p_paddr = 0,
+        .p_filesz = text_offset,
+        .p_memsz = text_offset,
+        .p_align = segment_align,
+    }, endian);
+    try writeStruct(writer, elf.Elf64_Phdr{
+        .p_type = elf.PT_LOAD,
+        .p_flags = elf.PF_R | elf.PF_W,
+        .p_offset = dynamic_offset,
+        .p_vaddr = dynamic_addr,
+        .p_paddr = dynamic_addr,
+        .p_filesz = dynamic_size,
+        .p_memsz = data_addr + data_size - dynamic_addr,
+        .p_align = segment_align,
+    }, endian);
+    try writeStruct(writer, elf.Elf64_Phdr{
+        .p_type = elf.PT_DYNAMIC,
+        .p_flags = elf.PF_R | elf.PF_W,
+        .p_offset = dynamic_offset,
+        .p_vaddr = dynamic_addr,
+        .p_paddr = dynamic_addr,
+        .p_filesz = dynamic_size,
+        .p_memsz = dynamic_size,
+        .p_align = 8,
+    }, endian);
+
+    assert(buffer.items.len == dynsym_offset);
+    try writeStruct(writer, mem.zeroes(elf.Elf64_Sym), endian);
+    var next_data_addr = data_addr;
+    for (options.symbols, name_offsets) |sym, name_offset| {
+        const is_object = sym.object_size != null;
+        try writeStruct(writer, elf.Elf64_Sym{
+            .st_name = name_offset,
+            .st_info = elf.STB_GLOBAL << 4 | @as(u8, if (is_object) elf.STT_OBJECT else elf.STT_FUNC),
+            .st_other = @intFromEnum(elf.STV.DEFAULT),
+            .st_shndx = @intFromEnum(if (is_object) SectionIndex.data else SectionIndex.text),
+            .st_value = if (is_object) next_data_addr else text_offset,
+            .st_size = sym.object_size orelse 0,
+        }, endian);
+        if (sym.object_size) |size| next_data_addr += mem.alignForward(usize, @max(size, 1), data_align);
+    }
+
+    assert(buffer.items.len == dynstr_offset);
+    try writer.writeAll(dynstr.items);
+
+    try writer.writeByteNTimes(0, versym_offset - buffer.items.len);
+    try writer.writeInt(elf.Elf64_Versym, elf.VER_NDX_LOCAL, endian);
+    for (options.symbols) |sym| {
+        // Index 1 is the base version, named after the library itself.
+        var versym: elf.Elf64_Versym = sym.version + 2;
+        if (!sym.is_default) versym |= elf.VERSYM_HIDDEN;
+        try writer.writeInt(elf.Elf64_Versym, versym, endian);
+    }
+
+    try writer.writeByteNTimes(0, verdef_offset - buffer.items.len);
+    for (0..options.versions.len + 1) |i| {
+        const name_offset = if (i == 0) soname_offset else version_offsets[i - 1];
+        const name = if (i == 0) options.soname else options.versions[i - 1];
+        try writeStruct(writer, elf.Elf64_Verdef{
+            .vd_version = 1,
+            .vd_flags = if (i == 0) elf.VER_FLG_BASE else 0,
+            .vd_ndx = @intCast(i + 1),
+            .vd_cnt = 1,
+            .vd_hash = hashName(name),
+            .vd_aux = @sizeOf(elf.Elf64_Verdef),
+            .vd_next = if (i == options.versions.len) 0 else verdef_entry_size,
+        }, endian);
+        try writeStruct(writer, elf.Elf64_Verdaux{
+            .vda_name = name_offset,
+            .vda_next = 0,
+        }, endian);
+    }
+
+    try writer.writeByteNTimes(0, dynamic_offset - buffer.items.len);
+    const dynamic = [dynamic_entries]elf.Elf64_Dyn{
+        .{ .d_tag = elf.DT_SONAME, .d_val = soname_offset },
+        .{ .d_tag = elf.DT_SYMTAB, .d_val = dynsym_offset },
+        .{ .d_tag = elf.DT_SYMENT, .d_val = @sizeOf(elf.Elf64_Sym) },
+        .{ .d_tag = elf.DT_STRTAB, .d_val = dynstr_offset },
+        .{ .d_tag = elf.DT_STRSZ, .d_val = dynstr.items.len },
+        .{ .d_tag = elf.DT_VERSYM, .d_val = versym_offset },
+        .{ .d_tag = elf.DT_VERDEF, .d_val = verdef_offset },
+        .{ .d_tag = elf.DT_VERDEFNUM, .d_val = options.versions.len + 1 },
+        .{ .d_tag = elf.DT_NULL, .d_val = 0 },
+    };
+    for (dynamic) |entry| try writeStruct(writer, entry, endian);
+
+    assert(buffer.items.len == shstrtab_offset);
+    try writer.writeAll(shstrtab);
+
+    try writer.writeByteNTimes(0, shoff - buffer.items.len);
+    for (std.enums.values(SectionIndex)) |index| {
+        const shdr: elf.Elf64_Shdr = switch (index) {
+            .null => mem.zeroes(elf.Elf64_Shdr),
+            .dynsym => .{
+                .sh_name = shstrtabOffset(shstrtab, ".dynsym"),
+                .sh_type = elf.SHT_DYNSYM,
+                .sh_flags = elf.SHF_ALLOC,
+                .sh_addr = dynsym_offset,
+                .sh_offset = dynsym_offset,
+                .sh_size = dynsym_size,
+                .sh_link = @intFromEnum(SectionIndex.dynstr),
+                // The index of the first non-local symbol.
+                .sh_info = 1,
+                .sh_addralign = 8,
+                .sh_entsize = @sizeOf(elf.Elf64_Sym),
+            },
+            .dynstr => .{
+                .sh_name = shstrtabOffset(shstrtab, ".dynstr"),
+                .sh_type = elf.SHT_STRTAB,
+                .sh_flags = elf.SHF_ALLOC,
+                .sh_addr = dynstr_offset,
+                .sh_offset = dynstr_offset,
+                .sh_size = dynstr.items.len,
+                .sh_link = 0,
+                .sh_info = 0,
+                .sh_addralign = 1,
+                .sh_entsize = 0,
+            },
+            .versym => .{
+                .sh_name = shstrtabOffset(shstrtab, ".gnu.version"),
+                .sh_type = elf.SHT_GNU_VERSYM,
+                .sh_flags = elf.SHF_ALLOC,
+                .sh_addr = versym_offset,
+                .sh_offset = versym_offset,
+                .sh_size = versym_size,
+                .sh_link = @intFromEnum(SectionIndex.dynsym),
+                .sh_info = 0,
+                .sh_addralign = 2,
+                .sh_entsize = @sizeOf(elf.Elf64_Versym),
+            },
+            .verdef => .{
+                .sh_name = shstrtabOffset(shstrtab, ".gnu.version_d"),
+                .sh_type = elf.SHT_GNU_VERDEF,
+                .sh_flags = elf.SHF_ALLOC,
+                .sh_addr = verdef_offset,
+                .sh_offset = verdef_offset,
+                .sh_size = verdef_size,
+                .sh_link = @intFromEnum(SectionIndex.dynstr),
+                .sh_info = @intCast(options.versions.len + 1),
+                .sh_addralign = 4,
+                .sh_entsize = 0,
+            },
+            .text => .{
+                .sh_name = shstrtabOffset(shstrtab, ".text"),
+                .sh_type = elf.SHT_PROGBITS,
+                .sh_flags = elf.SHF_ALLOC | elf.SHF_EXECINSTR,
+                .sh_addr = text_offset,
+                .sh_offset = text_offset,
+                .sh_size = 0,
+                .sh_link = 0,
+                .sh_info = 0,
+                .sh_addralign = data_align,
+                .sh_entsize = 0,
+            },
+            .dynamic => .{
+                .sh_name = shstrtabOffset(shstrtab, ".dynamic"),
+                .sh_type = elf.SHT_DYNAMIC,
+                .sh_flags = elf.SHF_ALLOC | elf.SHF_WRITE,
+                .sh_addr = dynamic_addr,
+                .sh_offset = dynamic_offset,
+                .sh_size = dynamic_size,
+                .sh_link = @intFromEnum(SectionIndex.dynstr),
+                .sh_info = 0,
+                .sh_addralign = 8,
+                .sh_entsize = @sizeOf(elf.Elf64_Dyn),
+            },
+            .data => .{
+                .sh_name = shstrtabOffset(shstrtab, ".data"),
+                .sh_type = elf.SHT_NOBITS,
+                .sh_flags = elf.SHF_ALLOC | elf.SHF_WRITE,
+                .sh_addr = data_addr,
+                .sh_offset = shstrtab_offset,
+                .sh_size = data_size,
+                .sh_link = 0,
+                .sh_info = 0,
+                .sh_addralign = data_align,
+                .sh_entsize = 0,
+            },
+            .shstrtab => .{
+                .sh_name = shstrtabOffset(shstrtab, ".shstrtab"),
+                .sh_type = elf.SHT_STRTAB,
+                .sh_flags = 0,
+                .sh_addr = 0,
+                .sh_offset = shstrtab_offset,
+                .sh_size = shstrtab.len,
+                .sh_link = 0,
+                .sh_info = 0,
+                .sh_addralign = 1,
+                .sh_entsize = 0,
+            },
+        };
+        try writeStruct(writer, shdr, endian);
+    }
+    assert(buffer.items.len == file_size);
+
+    try file.writeAll(buffer.items);
+}
+
+fn addString(strtab: *std.ArrayList(u8), offsets: *std.StringHashMap(u32), string: []const u8) !u32 {
+    const gop = try offsets.getOrPut(string);
+    if (!gop.found_existing) {
+        gop.value_ptr.* = @intCast(strtab.items.len);
+        try strtab.ensureUnusedCapacity(string.len + 1);
+        strtab.appendSliceAssumeCapacity(string);
+        strtab.appendAssumeCapacity(0);
+    }
+    return gop.value_ptr.*;
+}
+
+fn shstrtabOffset(comptime shstrtab: []const u8, comptime name: []const u8) u32 {
+    return comptime @intCast(mem.indexOf(u8, shstrtab, "\x00" ++ name ++ "\x00").? + 1);
+}
+
+/// The System V ABI hash function, which `vd_hash` uses.
+fn hashName(name: []const u8) u32 {
+    var h: u32 = 0;
+    for (name) |c| {
+        h = (h << 4) +% c;
+        const g = h & 0xf0000000;
+        if (g != 0) h ^= g >> 24;
+        h &= ~g;
+    }
+    return h;
+}
+
+fn writeStruct(writer: anytype, value: anytype, endian: std.builtin.Endian) !void {
+    inline for (std.meta.fields(@TypeOf(value))) |field| {
+        const field_value = @field(value, field.name);
+        switch (@typeInfo(field.type)) {
+            .Int => try writer.writeInt(field.type, field_value, endian),
+            .Enum => |info| try writer.writeInt(info.tag_type, @intFromEnum(field_value), endian),
+            .Array => try writer.writeAll(&field_value),
+            else => @compileError("unsupported field type: " ++ @typeName(field.type)),
+        }
+    }
+}
+
+test write {
+    const gpa = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    {
+        const file = try tmp.dir.createFile("libc.so.6", .{});
+        defer file.close();
+        try write(gpa, file, .{
+            .soname = "libc.so.6",
+            .machine = .X86_64,
+            .endian = .little,
+            .versions = &.{ "GLIBC_2.2.5", "GLIBC_2.34" },
+            .symbols = &.{
+                .{ .name = "pthread_create", .version = 0, .is_default = false, .object_size = null },
+                .{ .name = "pthread_create", .version = 1, .is_default = true, .object_size = null },
+                .{ .name = "environ", .version = 0, .is_default = true, .object_size = 8 },
+            },
+        });
+    }
+
+    const contents = try tmp.dir.readFileAlloc(gpa, "libc.so.6", 1 << 20);
+    defer gpa.free(contents);
+    const ehdr: *align(1) const elf.Elf64_Ehdr = @ptrCast(contents.ptr);
+    try std.testing.expectEqual(elf.ET.DYN, ehdr.e_type);
+    const shdrs = sliceAt(elf.Elf64_Shdr, contents, ehdr.e_shoff, ehdr.e_shnum);
+
+    const dynsym_shdr = shdrs[@intFromEnum(SectionIndex.dynsym)];
+    const dynstr_shdr = shdrs[dynsym_shdr.sh_link];
+    const symbols = sliceAt(elf.Elf64_Sym, contents, dynsym_shdr.sh_offset, 4);
+    const dynstr = sliceAt(u8, contents, dynstr_shdr.sh_offset, dynstr_shdr.sh_size);
+    try std.testing.expectEqualStrings("pthread_create", mem.sliceTo(dynstr[symbols[2].st_name..], 0));
+    try std.testing.expectEqualStrings("environ", mem.sliceTo(dynstr[symbols[3].st_name..], 0));
+    try std.testing.expectEqual(elf.STT_OBJECT, symbols[3].st_type());
+    try std.testing.expectEqual(8, symbols[3].st_size);
+
+    const versym_shdr = shdrs[@intFromEnum(SectionIndex.versym)];
+    const versyms = sliceAt(elf.Elf64_Versym, contents, versym_shdr.sh_offset, 4);
+    try std.testing.expectEqualSlices(elf.Elf64_Versym, &.{ 0, 2 | elf.VERSYM_HIDDEN, 3, 2 }, versyms);
+
+    const verdef_shdr = shdrs[@intFromEnum(SectionIndex.verdef)];
+    const last_verdef_offset = verdef_shdr.sh_offset + 2 * (@sizeOf(elf.Elf64_Verdef) + @sizeOf(elf.Elf64_Verdaux));
+    const verdef = sliceAt(elf.Elf64_Verdef, contents, last_verdef_offset, 1)[0];
+    try std.testing.expectEqual(3, verdef.vd_ndx);
+    try std.testing.expectEqual(0, verdef.vd_next);
+    const verdaux = sliceAt(elf.Elf64_Verdaux, contents, last_verdef_offset + verdef.vd_aux, 1)[0];
+    try std.testing.expectEqualStrings("GLIBC_2.34", mem.sliceTo(dynstr[verdaux.vda_name..], 0));
+}
+
+fn sliceAt(comptime T: type, bytes: []const u8, offset: u64, len: u64) []align(1) const T {
+    const start: usize = @intCast(offset);
+    return @as([*]align(1) const T, @ptrCast(bytes[start..].ptr))[0..@intCast(len)];
+}
+
+const std = @import("std");
+const assert = std.debug.assert;
+const elf = std.elf;
+const mem = std.mem;
+const Allocator = std.mem.Allocator;
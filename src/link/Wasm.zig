@@ -3472,13 +3472,19 @@ fn linkWithLLD(wasm: *Wasm, arena: Allocator, tid: Zcu.PerThread.Id, prog_node:
         try argv.appendSlice(&[_][]const u8{ comp.self_exe_path.?, linker_command });
         try argv.append("--error-limit=0");
 
-        if (comp.config.lto) {
+        if (comp.config.lto != .none) {
             switch (comp.root_mod.optimize_mode) {
                 .Debug => {},
                 .ReleaseSmall => try argv.append("-O2"),
                 .ReleaseFast, .ReleaseSafe => try argv.append("-O3"),
             }
         }
+        if (comp.config.lto == .thin) {
+            try argv.append(try std.fmt.allocPrint(arena, "--thinlto-jobs={d}", .{comp.thread_pool.getIdCount()}));
+            try argv.append(try std.fmt.allocPrint(arena, "--thinlto-cache-dir={s}", .{
+                try comp.global_cache_directory.join(arena, &.{"thinlto"}),
+            }));
+        }
 
         if (import_memory) {
             try argv.append("--import-memory");
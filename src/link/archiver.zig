@@ -0,0 +1,480 @@
+//! Writes GNU-format static libraries without going through LLVM. Members are
+//! scanned for global symbols on the thread pool and copied into place with
+//! positional writes, so neither step is serialized on the number of members.
+//!
+//! The symbols of each member are remembered in a small cache file, keyed by
+//! the member's path, size, inode and mtime, so that a rebuild only has to
+//! read the symbol tables of members which changed.
+
+pub const Options = struct {
+    /// Write a "!<thin>" archive, which refers to members instead of storing
+    /// a copy of them. Like `llvm-ar`, member paths are stored relative to the
+    /// directory containing the archive, so the archive keeps working when
+    /// that directory is renamed together with the members it contains.
+    thin: bool = false,
+    /// Location of the symbol cache file, or null to neither read nor write
+    /// one. It does not need to be next to the archive.
+    symbol_cache: ?struct { dir: fs.Dir, sub_path: []const u8 } = null,
+};
+
+/// Writes the archive `sub_path` in `dir` from the object files at
+/// `member_paths`, in that order. Returns `error.UnsupportedMember` without
+/// touching the output if any member is not an ELF relocatable object, such
+/// as LLVM bitcode when using LTO; the caller is expected to fall back to
+/// LLVM's archive writer in that case.
+pub fn writeGnu(
+    gpa: Allocator,
+    thread_pool: *std.Thread.Pool,
+    dir: fs.Dir,
+    sub_path: []const u8,
+    member_paths: []const []const u8,
+    options: Options,
+) !void {
+    var arena_allocator = std.heap.ArenaAllocator.init(gpa);
+    defer arena_allocator.deinit();
+    const arena = arena_allocator.allocator();
+
+    const symbol_cache = if (options.symbol_cache) |location|
+        try SymbolCache.load(arena, location.dir, location.sub_path)
+    else
+        SymbolCache{};
+
+    const members = try arena.alloc(Member, member_paths.len);
+    for (members, member_paths) |*member, path| member.* = .{ .path = path };
+    defer for (members) |member| if (member.owns_symbol_names) gpa.free(member.symbol_names);
+
+    {
+        var wait_group: WaitGroup = .{};
+        for (members) |*member| {
+            thread_pool.spawnWg(&wait_group, scanMember, .{ gpa, member, &symbol_cache });
+        }
+        thread_pool.waitAndWork(&wait_group);
+    }
+    for (members) |member| {
+        if (member.err) |err| {
+            log.debug("unable to scan archive member '{s}': {s}", .{ member.path, @errorName(err) });
+            return err;
+        }
+    }
+
+    // Layout: magic, symbol table, long name table, then each member header,
+    // followed by the member contents unless this is a thin archive.
+    var long_names = std.ArrayList(u8).init(arena);
+    const member_names = try arena.alloc([]const u8, members.len);
+    const archive_dir_path = if (options.thin)
+        try dir.realpathAlloc(arena, fs.path.dirname(sub_path) orelse ".")
+    else
+        undefined;
+    for (member_names, members) |*name, member| {
+        const basename = if (options.thin)
+            try fs.path.relative(arena, archive_dir_path, try fs.cwd().realpathAlloc(arena, member.path))
+        else
+            fs.path.basename(member.path);
+        if (!options.thin and basename.len < max_short_name_len and mem.indexOfScalar(u8, basename, '/') == null) {
+            name.* = try std.fmt.allocPrint(arena, "{s}/", .{basename});
+        } else {
+            name.* = try std.fmt.allocPrint(arena, "/{d}", .{long_names.items.len});
+            try long_names.writer().print("{s}/\n", .{basename});
+        }
+    }
+
+    var symbol_count: u64 = 0;
+    var symbol_names_len: u64 = 0;
+    for (members) |member| {
+        symbol_count += member.symbol_count;
+        symbol_names_len += member.symbol_names.len;
+    }
+
+    const is_64 = layout(members, long_names.items.len, symbol_count, symbol_names_len, options.thin, false) > maxInt(u32);
+    const end = layout(members, long_names.items.len, symbol_count, symbol_names_len, options.thin, is_64);
+
+    var prologue = std.ArrayList(u8).init(arena);
+    const writer = prologue.writer();
+    try writer.writeAll(if (options.thin) thin_magic else elf.ARMAG);
+    if (symbol_count > 0) {
+        const symtab_size = symtabSize(symbol_count, symbol_names_len, is_64);
+        try writeHeader(writer, if (is_64) elf.SYM64NAME else elf.SYMNAME, symtab_size);
+        const start = prologue.items.len;
+        if (is_64) try writer.writeInt(u64, symbol_count, .big) else try writer.writeInt(u32, @intCast(symbol_count), .big);
+        for (members) |member| for (0..member.symbol_count) |_| {
+            if (is_64) try writer.writeInt(u64, member.header_offset, .big) else try writer.writeInt(u32, @intCast(member.header_offset), .big);
+        };
+        for (members) |member| try writer.writeAll(member.symbol_names);
+        try writer.writeByteNTimes(0, symtab_size - (prologue.items.len - start));
+    }
+    if (long_names.items.len > 0) {
+        try writeHeader(writer, elf.STRNAME, long_names.items.len);
+        try writer.writeAll(long_names.items);
+        if (long_names.items.len % 2 != 0) try writer.writeByte('\n');
+    }
+    assert(members.len == 0 or prologue.items.len == members[0].header_offset);
+
+    var atomic_file = try dir.atomicFile(sub_path, .{});
+    defer atomic_file.deinit();
+    const out = atomic_file.file;
+    try out.setEndPos(end);
+    try out.pwriteAll(prologue.items, 0);
+
+    {
+        var wait_group: WaitGroup = .{};
+        for (members, member_names) |*member, name| {
+            thread_pool.spawnWg(&wait_group, writeMember, .{ out, member, name, options.thin });
+        }
+        thread_pool.waitAndWork(&wait_group);
+    }
+    for (members) |member| if (member.err) |err| return err;
+
+    try atomic_file.finish();
+
+    if (options.symbol_cache) |location| {
+        SymbolCache.save(arena, location.dir, location.sub_path, members) catch |err| {
+            log.warn("failed to save archive symbol cache: {s}", .{@errorName(err)});
+        };
+    }
+}
+
+const max_short_name_len = 16;
+const thin_magic = "!<thin>\n";
+const header_len = @sizeOf(elf.ar_hdr);
+
+const Member = struct {
+    path: []const u8,
+    stat: fs.File.Stat = undefined,
+    /// Names of the global symbols defined by this member, each followed by
+    /// a zero byte, in the form they are stored in the archive symbol table.
+    symbol_names: []const u8 = "",
+    symbol_count: u32 = 0,
+    /// Whether `symbol_names` was allocated with gpa rather than pointing
+    /// into the symbol cache.
+    owns_symbol_names: bool = false,
+    header_offset: u64 = 0,
+    err: ?anyerror = null,
+};
+
+fn symtabSize(symbol_count: u64, symbol_names_len: u64, is_64: bool) u64 {
+    const word_size: u64 = if (is_64) 8 else 4;
+    return mem.alignForward(u64, word_size * (symbol_count + 1) + symbol_names_len, 2);
+}
+
+/// Assigns `header_offset` of every member and returns the size of the archive.
+fn layout(
+    members: []Member,
+    long_names_len: usize,
+    symbol_count: u64,
+    symbol_names_len: u64,
+    thin: bool,
+    is_64: bool,
+) u64 {
+    var offset: u64 = elf.ARMAG.len;
+    if (symbol_count > 0) offset += header_len + symtabSize(symbol_count, symbol_names_len, is_64);
+    if (long_names_len > 0) offset += header_len + mem.alignForward(u64, long_names_len, 2);
+    for (members) |*member| {
+        member.header_offset = offset;
+        offset += header_len;
+        if (!thin) offset = mem.alignForward(u64, offset + member.stat.size, 2);
+    }
+    return offset;
+}
+
+/// Members are written deterministically: zero timestamp, owner and group,
+/// and mode 644, matching `llvm-ar D`.
+fn writeHeader(writer: anytype, name: []const u8, size: u64) !void {
+    var hdr: [header_len]u8 = undefined;
+    var stream = std.io.fixedBufferStream(&hdr);
+    stream.writer().print("{s: <16}{d: <12}{d: <6}{d: <6}{o: <8}{d: <10}", .{ name, 0, 0, 0, 0o644, size }) catch unreachable;
+    hdr[hdr.len - 2 ..][0..2].* = elf.ARFMAG.*;
+    try writer.writeAll(&hdr);
+}
+
+fn scanMember(gpa: Allocator, member: *Member, symbol_cache: *const SymbolCache) void {
+    scanMemberInner(gpa, member, symbol_cache) catch |err| {
+        member.err = err;
+    };
+}
+
+fn scanMemberInner(gpa: Allocator, member: *Member, symbol_cache: *const SymbolCache) !void {
+    const file = try fs.cwd().openFile(member.path, .{});
+    defer file.close();
+    member.stat = try file.stat();
+
+    if (symbol_cache.get(member.path, member.stat)) |cached| {
+        member.symbol_names = cached.symbol_names;
+        member.symbol_count = cached.symbol_count;
+        return;
+    }
+
+    // The identification bytes followed by `e_type`, which has the same
+    // offset in both classes.
+    var ident: [elf.EI_NIDENT + 2]u8 = undefined;
+    if (try file.preadAll(&ident, 0) != ident.len or !mem.eql(u8, ident[0..4], elf.MAGIC))
+        return error.UnsupportedMember;
+    const endian: std.builtin.Endian = switch (ident[elf.EI_DATA]) {
+        elf.ELFDATA2LSB => .little,
+        elf.ELFDATA2MSB => .big,
+        else => return error.UnsupportedMember,
+    };
+    if (mem.readInt(u16, ident[elf.EI_NIDENT..][0..2], endian) != @intFromEnum(elf.ET.REL))
+        return error.UnsupportedMember;
+    var symbol_names = std.ArrayList(u8).init(gpa);
+    defer symbol_names.deinit();
+    member.symbol_count = switch (ident[elf.EI_CLASS]) {
+        elf.ELFCLASS32 => try readSymbols(elf.Elf32_Ehdr, elf.Elf32_Shdr, elf.Elf32_Sym, gpa, file, endian, &symbol_names),
+        elf.ELFCLASS64 => try readSymbols(elf.Elf64_Ehdr, elf.Elf64_Shdr, elf.Elf64_Sym, gpa, file, endian, &symbol_names),
+        else => return error.UnsupportedMember,
+    };
+    member.symbol_names = try symbol_names.toOwnedSlice();
+    member.owns_symbol_names = true;
+}
+
+/// Appends the names of the symbols defined by the relocatable object `file`
+/// which are visible to the linker, and returns how many there were.
+fn readSymbols(
+    comptime Ehdr: type,
+    comptime Shdr: type,
+    comptime Sym: type,
+    gpa: Allocator,
+    file: fs.File,
+    endian: std.builtin.Endian,
+    symbol_names: *std.ArrayList(u8),
+) !u32 {
+    const ehdr = try preadStruct(Ehdr, file, 0, endian);
+    if (ehdr.e_shoff == 0) return error.UnsupportedMember;
+    if (ehdr.e_shentsize != @sizeOf(Shdr)) return error.UnsupportedMember;
+
+    // With more than SHN_LORESERVE sections, the count is stored in the
+    // first section header instead.
+    const shnum: usize = if (ehdr.e_shnum == 0)
+        math.cast(usize, (try preadStruct(Shdr, file, ehdr.e_shoff, endian)).sh_size) orelse return error.UnsupportedMember
+    else
+        ehdr.e_shnum;
+    const shdrs = try gpa.alloc(Shdr, shnum);
+    defer gpa.free(shdrs);
+    try preadSlice(Shdr, file, shdrs, ehdr.e_shoff, endian);
+
+    const symtab_shdr = for (shdrs) |shdr| {
+        if (shdr.sh_type == elf.SHT_SYMTAB) break shdr;
+    } else return 0;
+    if (symtab_shdr.sh_entsize != @sizeOf(Sym) or symtab_shdr.sh_link >= shdrs.len) return error.UnsupportedMember;
+    const strtab_shdr = shdrs[symtab_shdr.sh_link];
+
+    const syms = try gpa.alloc(Sym, math.cast(usize, symtab_shdr.sh_size / @sizeOf(Sym)) orelse return error.UnsupportedMember);
+    defer gpa.free(syms);
+    try preadSlice(Sym, file, syms, symtab_shdr.sh_offset, endian);
+
+    const strtab = try gpa.alloc(u8, math.cast(usize, strtab_shdr.sh_size) orelse return error.UnsupportedMember);
+    defer gpa.free(strtab);
+    if (try file.preadAll(strtab, strtab_shdr.sh_offset) != strtab.len) return error.UnexpectedEndOfFile;
+
+    // Local symbols come first; `sh_info` is the index of the first global one.
+    var count: u32 = 0;
+    for (syms[@min(symtab_shdr.sh_info, syms.len)..]) |sym| {
+        if (sym.st_bind() == elf.STB_LOCAL or sym.st_shndx == elf.SHN_UNDEF) continue;
+        switch (sym.st_type()) {
+            elf.STT_SECTION, elf.STT_FILE => continue,
+            else => {},
+        }
+        if (sym.st_name >= strtab.len) return error.UnsupportedMember;
+        const name = mem.sliceTo(strtab[sym.st_name..], 0);
+        if (name.len == 0) continue;
+        try symbol_names.ensureUnusedCapacity(name.len + 1);
+        symbol_names.appendSliceAssumeCapacity(name);
+        symbol_names.appendAssumeCapacity(0);
+        count += 1;
+    }
+    return count;
+}
+
+fn preadStruct(comptime T: type, file: fs.File, offset: u64, endian: std.builtin.Endian) !T {
+    var result: T = undefined;
+    try preadSlice(T, file, (&result)[0..1], offset, endian);
+    return result;
+}
+
+fn preadSlice(comptime T: type, file: fs.File, items: []T, offset: u64, endian: std.builtin.Endian) !void {
+    const bytes = mem.sliceAsBytes(items);
+    if (try file.preadAll(bytes, offset) != bytes.len) return error.UnexpectedEndOfFile;
+    if (endian != native_endian) for (items) |*item| mem.byteSwapAllFields(T, item);
+}
+
+fn writeMember(out: fs.File, member: *Member, name: []const u8, thin: bool) void {
+    writeMemberInner(out, member, name, thin) catch |err| {
+        member.err = err;
+    };
+}
+
+fn writeMemberInner(out: fs.File, member: *Member, name: []const u8, thin: bool) !void {
+    var hdr: [header_len]u8 = undefined;
+    var stream = std.io.fixedBufferStream(&hdr);
+    try writeHeader(stream.writer(), name, member.stat.size);
+    try out.pwriteAll(&hdr, member.header_offset);
+    if (thin) return;
+
+    const file = try fs.cwd().openFile(member.path, .{});
+    defer file.close();
+    const data_offset = member.header_offset + header_len;
+    if (try file.copyRangeAll(0, out, data_offset, member.stat.size) != member.stat.size)
+        return error.UnexpectedEndOfFile;
+    if (member.stat.size % 2 != 0) try out.pwriteAll("\n", data_offset + member.stat.size);
+}
+
+/// The cache file starts with `version_line`, followed by one record per
+/// member: a text line "<size> <inode> <mtime> <symbol count> <names len> <path>"
+/// and then the symbol names exactly as they appear in `Member.symbol_names`.
+const SymbolCache = struct {
+    entries: std.StringHashMapUnmanaged(Entry) = .{},
+
+    const version_line = "zig archive symbols 1\n";
+
+    const Entry = struct {
+        size: u64,
+        inode: fs.File.INode,
+        mtime: i128,
+        symbol_names: []const u8,
+        symbol_count: u32,
+    };
+
+    fn get(cache: *const SymbolCache, path: []const u8, stat: fs.File.Stat) ?Entry {
+        const entry = cache.entries.get(path) orelse return null;
+        // Recorded by `save` for members whose mtime could not be trusted.
+        if (entry.mtime == 0) return null;
+        if (entry.size != stat.size or entry.inode != stat.inode or entry.mtime != stat.mtime) return null;
+        return entry;
+    }
+
+    /// A missing or malformed cache is treated as empty.
+    fn load(arena: Allocator, dir: fs.Dir, sub_path: []const u8) Allocator.Error!SymbolCache {
+        var cache: SymbolCache = .{};
+        const contents = dir.readFileAlloc(arena, sub_path, math.maxInt(u32)) catch |err| switch (err) {
+            error.OutOfMemory => return error.OutOfMemory,
+            else => return cache,
+        };
+        cache.parse(arena, contents) catch |err| switch (err) {
+            error.OutOfMemory => return error.OutOfMemory,
+            else => {
+                log.debug("ignoring malformed archive symbol cache: {s}", .{@errorName(err)});
+                cache.entries = .{};
+            },
+        };
+        return cache;
+    }
+
+    fn parse(cache: *SymbolCache, arena: Allocator, contents: []const u8) !void {
+        if (!mem.startsWith(u8, contents, version_line)) return error.InvalidFormat;
+        var i: usize = version_line.len;
+        while (i < contents.len) {
+            const line_end = mem.indexOfScalarPos(u8, contents, i, '\n') orelse return error.InvalidFormat;
+            var it = mem.splitScalar(u8, contents[i..line_end], ' ');
+            const size = try std.fmt.parseInt(u64, it.next() orelse return error.InvalidFormat, 10);
+            const inode = try std.fmt.parseInt(fs.File.INode, it.next() orelse return error.InvalidFormat, 10);
+            const mtime = try std.fmt.parseInt(i128, it.next() orelse return error.InvalidFormat, 10);
+            const symbol_count = try std.fmt.parseInt(u32, it.next() orelse return error.InvalidFormat, 10);
+            const names_len = try std.fmt.parseInt(usize, it.next() orelse return error.InvalidFormat, 10);
+            const path = it.rest();
+            if (names_len > contents.len - line_end - 1) return error.InvalidFormat;
+            const symbol_names = contents[line_end + 1 ..][0..names_len];
+            if (mem.count(u8, symbol_names, "\x00") != symbol_count) return error.InvalidFormat;
+            try cache.entries.put(arena, path, .{
+                .size = size,
+                .inode = inode,
+                .mtime = mtime,
+                .symbol_names = symbol_names,
+                .symbol_count = symbol_count,
+            });
+            i = line_end + 1 + names_len;
+        }
+    }
+
+    /// The file is replaced atomically, since several compilations may share it.
+    fn save(arena: Allocator, dir: fs.Dir, sub_path: []const u8, members: []const Member) !void {
+        var atomic_file = try dir.atomicFile(sub_path, .{});
+        defer atomic_file.deinit();
+
+        // As in `Cache.Manifest.isProblematicTimestamp`, a member modified no
+        // earlier than the file system's current time could be modified again
+        // without its mtime changing, so it is recorded with a zero mtime and
+        // scanned again next time.
+        const problematic_timestamp = (try atomic_file.file.stat()).mtime;
+
+        var contents = std.ArrayList(u8).init(arena);
+        const writer = contents.writer();
+        try writer.writeAll(version_line);
+        for (members) |member| {
+            const trusted = member.stat.mtime < problematic_timestamp;
+            try writer.print("{d} {d} {d} {d} {d} {s}\n", .{
+                member.stat.size,
+                if (trusted) member.stat.inode else 0,
+                if (trusted) member.stat.mtime else 0,
+                member.symbol_count,
+                member.symbol_names.len,
+                member.path,
+            });
+            try writer.writeAll(member.symbol_names);
+        }
+        try atomic_file.file.writeAll(contents.items);
+        try atomic_file.finish();
+    }
+};
+
+test writeHeader {
+    var buf = std.ArrayList(u8).init(std.testing.allocator);
+    defer buf.deinit();
+    try writeHeader(buf.writer(), "foo.o/", 1234);
+    try std.testing.expectEqualStrings("foo.o/          0           0     0     644     1234      `\n", buf.items);
+}
+
+test "SymbolCache round trip" {
+    var arena_allocator = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena_allocator.deinit();
+    const arena = arena_allocator.allocator();
+
+    var stat: fs.File.Stat = undefined;
+    stat.size = 100;
+    stat.inode = 7;
+    stat.mtime = 123456789;
+    const members = [_]Member{
+        .{ .path = "a b.o", .stat = stat, .symbol_names = "foo\x00bar\x00", .symbol_count = 2 },
+        .{ .path = "c.o", .stat = stat },
+    };
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    try SymbolCache.save(arena, tmp.dir, "symbols", &members);
+    const cache = try SymbolCache.load(arena, tmp.dir, "symbols");
+
+    const a = cache.get("a b.o", stat).?;
+    try std.testing.expectEqualStrings("foo\x00bar\x00", a.symbol_names);
+    try std.testing.expectEqual(2, a.symbol_count);
+    try std.testing.expectEqual(0, cache.get("c.o", stat).?.symbol_count);
+    stat.mtime += 1;
+    try std.testing.expect(cache.get("c.o", stat) == null);
+}
+
+test "SymbolCache does not trust recent timestamps" {
+    var arena_allocator = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena_allocator.deinit();
+    const arena = arena_allocator.allocator();
+
+    var stat: fs.File.Stat = undefined;
+    stat.size = 100;
+    stat.inode = 7;
+    stat.mtime = maxInt(i64);
+    const members = [_]Member{.{ .path = "a.o", .stat = stat, .symbol_names = "foo\x00", .symbol_count = 1 }};
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    try SymbolCache.save(arena, tmp.dir, "symbols", &members);
+    const cache = try SymbolCache.load(arena, tmp.dir, "symbols");
+    try std.testing.expect(cache.get("a.o", stat) == null);
+}
+
+const std = @import("std");
+const assert = std.debug.assert;
+const elf = std.elf;
+const fs = std.fs;
+const log = std.log.scoped(.link);
+const math = std.math;
+const maxInt = std.math.maxInt;
+const mem = std.mem;
+const native_endian = @import("builtin").target.cpu.arch.endian();
+const Allocator = std.mem.Allocator;
+const WaitGroup = std.Thread.WaitGroup;
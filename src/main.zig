@@ -432,6 +432,8 @@ const usage_build_generic =
     \\  --show-builtin            Output the source of @import("builtin") then exit
     \\  --cache-dir [path]        Override the local cache directory
     \\  --global-cache-dir [path] Override the global cache directory
+    \\  --runtime-store [path]    Use prebuilt runtime libraries from this directory
+    \\  --populate-runtime-store  Add runtime libraries built from source to the runtime store
     \\  --zig-lib-dir [path]      Override path to Zig installation lib directory
     \\
     \\Global Compile Options:
@@ -453,6 +455,9 @@ const usage_build_generic =
     \\  -fPIE                     Force-enable Position Independent Executable
     \\  -fno-PIE                  Force-disable Position Independent Executable
     \\  -flto                     Force-enable Link Time Optimization (requires LLVM extensions)
+    \\  -flto=[mode]              Force-enable Link Time Optimization with the given mode
+    \\    full                    (default) Merge the whole program into one module
+    \\    thin                    Optimize modules in parallel, import across them using summaries
     \\  -fno-lto                  Force-disable Link Time Optimization
     \\  -fdll-export-fns          Mark exported functions as DLL exports (Windows)
     \\  -fno-dll-export-fns       Force-disable marking exported functions as DLL exports
@@ -466,6 +471,14 @@ const usage_build_generic =
     \\  -fno-data-sections        All data go into same section
     \\  -fformatted-panics        Enable formatted safety panics
     \\  -fno-formatted-panics     Disable formatted safety panics
+    \\  -fair-optimize            Remove redundant safety checks before code generation
+    \\  -fno-air-optimize         (default) Lower analyzed code as-is
+    \\  -fclang-in-process        Compile C/C++ files on the thread pool instead of in child processes
+    \\  -fno-clang-in-process     (default) Spawn a child process for each C/C++ file
+    \\  -fcimport-skip-function-bodies  Translate C functions with bodies as compile errors
+    \\  -fno-cimport-skip-function-bodies  (default) Translate C function bodies
+    \\  -fthin-archive            Make static libraries refer to object files instead of copying them
+    \\  -fno-thin-archive         (default) Copy object files into static libraries
     \\  -fstructured-cfg          (SPIR-V) force SPIR-V kernels to use structured control flow
     \\  -fno-structured-cfg       (SPIR-V) force SPIR-V kernels to not use structured control flow
     \\  -mexec-model=[value]      (WASI) Execution model
@@ -642,6 +655,7 @@ const usage_build_generic =
     \\Debug Options (Zig Compiler Development):
     \\  -fopt-bisect-limit=[limit]   Only run [limit] first LLVM optimization passes
     \\  -ftime-report                Print timing diagnostics
+    \\  -ftime-trace=[path]          Write a Chrome trace of compiler stages to path
     \\  -fstack-report               Print stack size diagnostics
     \\  --verbose-link               Display linker invocations
     \\  --verbose-cc                 Display C compiler invocations
@@ -827,6 +841,10 @@ fn buildOutputType(
     var have_version = false;
     var compatibility_version: ?std.SemanticVersion = null;
     var formatted_panics: ?bool = null;
+    var air_optimize = false;
+    var clang_in_process = false;
+    var cimport_skip_function_bodies = false;
+    var thin_archive = false;
     var function_sections = false;
     var data_sections = false;
     var no_builtin = false;
@@ -844,6 +862,7 @@ fn buildOutputType(
     var verbose_cimport = false;
     var verbose_llvm_cpu_features = false;
     var time_report = false;
+    var time_trace: ?[]const u8 = null;
     var stack_report = false;
     var show_builtin = false;
     var emit_bin: EmitBin = .yes_default_path;
@@ -908,6 +927,8 @@ fn buildOutputType(
     var override_local_cache_dir: ?[]const u8 = try EnvVar.ZIG_LOCAL_CACHE_DIR.get(arena);
     var override_global_cache_dir: ?[]const u8 = try EnvVar.ZIG_GLOBAL_CACHE_DIR.get(arena);
     var override_lib_dir: ?[]const u8 = try EnvVar.ZIG_LIB_DIR.get(arena);
+    var runtime_store_path: ?[]const u8 = try EnvVar.ZIG_RUNTIME_STORE.get(arena);
+    var populate_runtime_store = false;
     var clang_preprocessor_mode: Compilation.ClangPreprocessorMode = .no;
     var subsystem: ?std.Target.SubSystem = null;
     var major_subsystem_version: ?u16 = null;
@@ -1320,6 +1341,10 @@ fn buildOutputType(
                         override_local_cache_dir = args_iter.nextOrFatal();
                     } else if (mem.eql(u8, arg, "--global-cache-dir")) {
                         override_global_cache_dir = args_iter.nextOrFatal();
+                    } else if (mem.eql(u8, arg, "--runtime-store")) {
+                        runtime_store_path = args_iter.nextOrFatal();
+                    } else if (mem.eql(u8, arg, "--populate-runtime-store")) {
+                        populate_runtime_store = true;
                     } else if (mem.eql(u8, arg, "--zig-lib-dir")) {
                         override_lib_dir = args_iter.nextOrFatal();
                     } else if (mem.eql(u8, arg, "--debug-log")) {
@@ -1377,6 +1402,8 @@ fn buildOutputType(
                         test_no_exec = true;
                     } else if (mem.eql(u8, arg, "-ftime-report")) {
                         time_report = true;
+                    } else if (mem.startsWith(u8, arg, "-ftime-trace=")) {
+                        time_trace = arg["-ftime-trace=".len..];
                     } else if (mem.eql(u8, arg, "-fstack-report")) {
                         stack_report = true;
                     } else if (mem.eql(u8, arg, "-fPIC")) {
@@ -1388,9 +1415,13 @@ fn buildOutputType(
                     } else if (mem.eql(u8, arg, "-fno-PIE")) {
                         create_module.opts.pie = false;
                     } else if (mem.eql(u8, arg, "-flto")) {
-                        create_module.opts.lto = true;
+                        create_module.opts.lto = .full;
+                    } else if (mem.startsWith(u8, arg, "-flto=")) {
+                        const mode = arg["-flto=".len..];
+                        create_module.opts.lto = std.meta.stringToEnum(std.zig.LtoMode, mode) orelse
+                            fatal("unrecognized LTO mode: '{s}'", .{mode});
                     } else if (mem.eql(u8, arg, "-fno-lto")) {
-                        create_module.opts.lto = false;
+                        create_module.opts.lto = .none;
                     } else if (mem.eql(u8, arg, "-funwind-tables")) {
                         mod_opts.unwind_tables = true;
                     } else if (mem.eql(u8, arg, "-fno-unwind-tables")) {
@@ -1540,6 +1571,22 @@ fn buildOutputType(
                         formatted_panics = true;
                     } else if (mem.eql(u8, arg, "-fno-formatted-panics")) {
                         formatted_panics = false;
+                    } else if (mem.eql(u8, arg, "-fair-optimize")) {
+                        air_optimize = true;
+                    } else if (mem.eql(u8, arg, "-fno-air-optimize")) {
+                        air_optimize = false;
+                    } else if (mem.eql(u8, arg, "-fclang-in-process")) {
+                        clang_in_process = true;
+                    } else if (mem.eql(u8, arg, "-fno-clang-in-process")) {
+                        clang_in_process = false;
+                    } else if (mem.eql(u8, arg, "-fcimport-skip-function-bodies")) {
+                        cimport_skip_function_bodies = true;
+                    } else if (mem.eql(u8, arg, "-fno-cimport-skip-function-bodies")) {
+                        cimport_skip_function_bodies = false;
+                    } else if (mem.eql(u8, arg, "-fthin-archive")) {
+                        thin_archive = true;
+                    } else if (mem.eql(u8, arg, "-fno-thin-archive")) {
+                        thin_archive = false;
                     } else if (mem.eql(u8, arg, "-fsingle-threaded")) {
                         mod_opts.single_threaded = true;
                     } else if (mem.eql(u8, arg, "-fno-single-threaded")) {
@@ -1912,8 +1959,8 @@ fn buildOutputType(
                     .no_pic => mod_opts.pic = false,
                     .pie => create_module.opts.pie = true,
                     .no_pie => create_module.opts.pie = false,
-                    .lto => create_module.opts.lto = true,
-                    .no_lto => create_module.opts.lto = false,
+                    .lto => create_module.opts.lto = if (mem.eql(u8, it.only_arg, "thin")) .thin else .full,
+                    .no_lto => create_module.opts.lto = .none,
                     .red_zone => mod_opts.red_zone = true,
                     .no_red_zone => mod_opts.red_zone = false,
                     .omit_frame_pointer => mod_opts.omit_frame_pointer = true,
@@ -2783,6 +2830,23 @@ fn buildOutputType(
     };
     defer global_cache_directory.handle.close();
 
+    var runtime_store: ?Compilation.RuntimeStore = if (runtime_store_path) |p| .{
+        .directory = .{
+            .handle = (if (populate_runtime_store)
+                fs.cwd().makeOpenPath(p, .{})
+            else
+                fs.cwd().openDir(p, .{})) catch |err| {
+                fatal("unable to open runtime store '{s}': {s}", .{ p, @errorName(err) });
+            },
+            .path = p,
+        },
+        .populate = populate_runtime_store,
+    } else if (populate_runtime_store)
+        fatal("--populate-runtime-store requires --runtime-store or ZIG_RUNTIME_STORE", .{})
+    else
+        null;
+    defer if (runtime_store) |*store| store.directory.handle.close();
+
     if (linker_optimization) |o| {
         warn("ignoring deprecated linker optimization setting '{s}'", .{o});
     }
@@ -3285,6 +3349,7 @@ fn buildOutputType(
         .global_cache_directory = global_cache_directory,
         .thread_pool = &thread_pool,
         .self_exe_path = self_exe_path,
+        .runtime_store = runtime_store,
         .config = create_module.resolved_options,
         .root_name = root_name,
         .sysroot = create_module.sysroot,
@@ -3359,6 +3424,10 @@ fn buildOutputType(
         .stack_size = stack_size,
         .image_base = image_base,
         .formatted_panics = formatted_panics,
+        .air_optimize = air_optimize,
+        .clang_in_process = clang_in_process,
+        .cimport_skip_function_bodies = cimport_skip_function_bodies,
+        .thin_archive = thin_archive,
         .function_sections = function_sections,
         .data_sections = data_sections,
         .no_builtin = no_builtin,
@@ -3377,6 +3446,7 @@ fn buildOutputType(
         .verbose_cimport = verbose_cimport,
         .verbose_llvm_cpu_features = verbose_llvm_cpu_features,
         .time_report = time_report,
+        .time_trace = time_trace,
         .stack_report = stack_report,
         .build_id = build_id,
         .test_filters = test_filters.items,
@@ -4533,6 +4603,7 @@ fn cmdTranslateC(
 
     man.hash.add(@as(u16, 0xb945)); // Random number to distinguish translate-c from compiling C objects
     man.hash.add(comp.config.c_frontend);
+    man.hash.add(comp.cimport_skip_function_bodies);
     Compilation.cache_helpers.hashCSource(&man, c_source_file) catch |err| {
         fatal("unable to process '{s}': {s}", .{ c_source_file.src_path, @errorName(err) });
     };
@@ -4611,6 +4682,7 @@ fn cmdTranslateC(
                     new_argv.ptr + new_argv.len,
                     &errors,
                     c_headers_dir_path_z,
+                    comp.cimport_skip_function_bodies,
                 ) catch |err| switch (err) {
                     error.OutOfMemory => return error.OutOfMemory,
                     error.SemanticAnalyzeFail => {
@@ -5137,6 +5209,19 @@ fn cmdBuild(gpa: Allocator, arena: Allocator, args: []const []const u8) !void {
                     try http_client.initDefaultProxies(arena);
                 }
 
+                // Packages are downloaded on their own pool, so that more of
+                // them can wait on the network at once than there are CPUs.
+                var fetch_thread_pool: ThreadPool = undefined;
+                const use_fetch_thread_pool = !job_queue.read_only;
+                if (use_fetch_thread_pool) {
+                    try fetch_thread_pool.init(.{
+                        .allocator = gpa,
+                        .n_jobs = Package.Fetch.JobQueue.max_concurrent_fetches,
+                    });
+                    job_queue.fetch_thread_pool = &fetch_thread_pool;
+                }
+                defer if (use_fetch_thread_pool) fetch_thread_pool.deinit();
+
                 try job_queue.all_fetches.ensureUnusedCapacity(gpa, 1);
                 try job_queue.table.ensureUnusedCapacity(gpa, 1);
 
@@ -5173,10 +5258,10 @@ fn cmdBuild(gpa: Allocator, arena: Allocator, args: []const []const u8) !void {
                     &fetch,
                 );
 
-                job_queue.thread_pool.spawnWg(&job_queue.wait_group, Package.Fetch.workerRun, .{
+                job_queue.fetchThreadPool().spawnWg(&job_queue.wait_group, Package.Fetch.workerRun, .{
                     &fetch, "root",
                 });
-                job_queue.wait_group.wait();
+                job_queue.fetchThreadPool().waitAndWork(&job_queue.wait_group);
 
                 try job_queue.consolidateErrors();
 
@@ -5655,6 +5740,7 @@ extern fn ZigClangIsLLVMUsingSeparateLibcxx() bool;
 
 extern "c" fn ZigClang_main(argc: c_int, argv: [*:null]?[*:0]u8) c_int;
 extern "c" fn ZigLlvmAr_main(argc: c_int, argv: [*:null]?[*:0]u8) c_int;
+extern "c" fn ZigClang_compileInProcess(argc: c_int, argv: [*:null]?[*:0]u8, stderr_ptr: *?[*]u8, stderr_len: *usize) c_int;
 
 fn argsCopyZ(alloc: Allocator, args: []const []const u8) ![:null]?[*:0]u8 {
     var argv = try alloc.allocSentinel(?[*:0]u8, args.len, null);
@@ -5678,6 +5764,31 @@ pub fn clangMain(alloc: Allocator, args: []const []const u8) error{OutOfMemory}!
     return @as(u8, @bitCast(@as(i8, @truncate(exit_code))));
 }
 
+pub const ClangInProcessResult = struct {
+    exit_code: u8,
+    /// Text diagnostics which clang would have printed to stderr.
+    stderr: []const u8,
+};
+
+/// Runs `zig clang` with `args` on the calling thread rather than in a child
+/// process. Safe to call from multiple threads at once. Returns `null` if the
+/// command line cannot be run in-process, in which case the caller should
+/// spawn a child process as usual.
+pub fn clangInProcess(arena: Allocator, args: []const []const u8) error{OutOfMemory}!?ClangInProcessResult {
+    if (!build_options.have_llvm) return null;
+
+    const argv = try argsCopyZ(arena, args);
+    var stderr_ptr: ?[*]u8 = null;
+    var stderr_len: usize = 0;
+    const exit_code = ZigClang_compileInProcess(@intCast(argv.len), argv.ptr, &stderr_ptr, &stderr_len);
+    defer if (stderr_ptr) |ptr| std.c.free(ptr);
+    if (exit_code < 0) return null;
+    return .{
+        .exit_code = std.math.cast(u8, exit_code) orelse 1,
+        .stderr = if (stderr_ptr) |ptr| try arena.dupe(u8, ptr[0..stderr_len]) else "",
+    };
+}
+
 pub fn llvmArMain(alloc: Allocator, args: []const []const u8) error{OutOfMemory}!u8 {
     if (!build_options.have_llvm)
         fatal("`zig ar`, `zig dlltool`, `zig ranlib', and `zig lib` unavailable: compiler built without LLVM extensions", .{});
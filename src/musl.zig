@@ -249,6 +249,8 @@ pub fn buildCRTFile(comp: *Compilation, crt_file: CRTFile, prog_node: std.Progre
                 .zig_lib_directory = comp.zig_lib_directory,
                 .self_exe_path = comp.self_exe_path,
                 .cache_mode = .whole,
+                .runtime_store = comp.runtime_store,
+                .use_runtime_store = true,
                 .config = config,
                 .root_mod = root_mod,
                 .thread_pool = comp.thread_pool,
@@ -256,6 +258,7 @@ pub fn buildCRTFile(comp: *Compilation, crt_file: CRTFile, prog_node: std.Progre
                 .libc_installation = comp.libc_installation,
                 .emit_bin = .{ .directory = null, .basename = "libc.so" },
                 .emit_h = null,
+                .clang_in_process = comp.clang_in_process,
                 .verbose_cc = comp.verbose_cc,
                 .verbose_link = comp.verbose_link,
                 .verbose_air = comp.verbose_air,
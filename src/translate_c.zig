@@ -56,6 +56,10 @@ pub const Context = struct {
 
     pattern_list: PatternList,
 
+    /// Translate function definitions as declarations which fail when
+    /// referenced, instead of translating their bodies.
+    skip_function_bodies: bool,
+
     fn getMangle(c: *Context) u32 {
         c.mangle_count += 1;
         return c.mangle_count;
@@ -84,6 +88,7 @@ pub fn translate(
     args_end: [*]?[*]const u8,
     errors: *std.zig.ErrorBundle,
     resources_path: [*:0]const u8,
+    skip_function_bodies: bool,
 ) !std.zig.Ast {
     var clang_errors: []clang.ErrorMsg = &.{};
 
@@ -93,6 +98,7 @@ pub fn translate(
         &clang_errors.ptr,
         &clang_errors.len,
         resources_path,
+        skip_function_bodies,
     ) orelse {
         defer clang.ErrorMsg.delete(clang_errors.ptr, clang_errors.len);
 
@@ -148,6 +154,7 @@ pub fn translate(
         .global_scope = try arena.create(Scope.Root),
         .clang_context = ast_unit.getASTContext(),
         .pattern_list = try PatternList.init(gpa),
+        .skip_function_bodies = skip_function_bodies,
     };
     context.global_scope.* = Scope.Root.init(&context);
     defer {
@@ -171,7 +178,7 @@ pub fn translate(
 
     try prepopulateGlobalNameTable(ast_unit, &context);
 
-    if (!ast_unit.visitLocalTopLevelDecls(&context, declVisitorC)) {
+    if (!ast_unit.visitTopLevelDecls(&context, declVisitorC)) {
         return error.OutOfMemory;
     }
 
@@ -206,13 +213,13 @@ fn isSelfDefinedMacro(unit: *const clang.ASTUnit, c: *const Context, macro: *con
 }
 
 fn prepopulateGlobalNameTable(ast_unit: *clang.ASTUnit, c: *Context) !void {
-    if (!ast_unit.visitLocalTopLevelDecls(c, declVisitorNamesOnlyC)) {
+    if (!ast_unit.visitTopLevelDecls(c, declVisitorNamesOnlyC)) {
         return error.OutOfMemory;
     }
 
     // TODO if we see #undef, delete it from the table
-    var it = ast_unit.getLocalPreprocessingEntities_begin();
-    const it_end = ast_unit.getLocalPreprocessingEntities_end();
+    var it = ast_unit.getPreprocessingEntities_begin();
+    const it_end = ast_unit.getPreprocessingEntities_end();
 
     while (it.I != it_end.I) : (it.I += 1) {
         const entity = it.deref();
@@ -380,6 +387,11 @@ fn visitFnDecl(c: *Context, fn_decl: *const clang.FunctionDecl) Error!void {
 
     const fn_decl_loc = fn_decl.getLocation();
     const has_body = fn_decl.hasBody();
+    if (c.skip_function_bodies and (has_body or fn_decl.hasSkippedBody())) {
+        // Clang skips bodies while parsing, but definitions loaded from a
+        // precompiled header still have them.
+        return failDecl(c, fn_decl_loc, fn_name, "function body not translated due to -fcimport-skip-function-bodies", .{});
+    }
     const storage_class = fn_decl.getStorageClass();
     const is_always_inline = has_body and fn_decl.hasAlwaysInlineAttr();
     var decl_ctx = FnDeclContext{
@@ -5261,8 +5273,8 @@ fn getMacroText(unit: *const clang.ASTUnit, c: *const Context, macro: *const cla
 
 fn transPreprocessorEntities(c: *Context, unit: *clang.ASTUnit) Error!void {
     // TODO if we see #undef, delete it from the table
-    var it = unit.getLocalPreprocessingEntities_begin();
-    const it_end = unit.getLocalPreprocessingEntities_end();
+    var it = unit.getPreprocessingEntities_begin();
+    const it_end = unit.getPreprocessingEntities_end();
     var tok_list = std.ArrayList(CToken).init(c.gpa);
     defer tok_list.deinit();
     const scope = c.global_scope;
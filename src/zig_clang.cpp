@@ -2399,24 +2399,42 @@ ZigClangSourceManager *ZigClangASTUnit_getSourceManager(ZigClangASTUnit *self) {
     return reinterpret_cast<ZigClangSourceManager *>(result);
 }
 
-bool ZigClangASTUnit_visitLocalTopLevelDecls(ZigClangASTUnit *self, void *context,
+bool ZigClangASTUnit_visitTopLevelDecls(ZigClangASTUnit *self, void *context,
     bool (*Fn)(void *context, const ZigClangDecl *decl))
 {
-    return reinterpret_cast<clang::ASTUnit *>(self)->visitLocalTopLevelDecls(context,
-            reinterpret_cast<bool (*)(void *, const clang::Decl *)>(Fn));
+    clang::ASTUnit *unit = reinterpret_cast<clang::ASTUnit *>(self);
+    clang::ASTContext &ctx = unit->getASTContext();
+    if (ctx.getExternalSource() == nullptr) {
+        return unit->visitLocalTopLevelDecls(context,
+                reinterpret_cast<bool (*)(void *, const clang::Decl *)>(Fn));
+    }
+    // Declarations loaded from a precompiled header (-include-pch) are not
+    // "local" to the ASTUnit, so walk the translation unit instead. This
+    // deserializes them in source order, followed by the local ones.
+    for (const clang::Decl *decl : ctx.getTranslationUnitDecl()->decls()) {
+        if (decl->isImplicit()) continue;
+        if (!Fn(context, reinterpret_cast<const ZigClangDecl *>(decl))) return false;
+    }
+    return true;
 }
 
-struct ZigClangPreprocessingRecord_iterator ZigClangASTUnit_getLocalPreprocessingEntities_begin(
+struct ZigClangPreprocessingRecord_iterator ZigClangASTUnit_getPreprocessingEntities_begin(
         struct ZigClangASTUnit *self)
 {
-    auto casted = reinterpret_cast<const clang::ASTUnit *>(self);
+    auto casted = reinterpret_cast<clang::ASTUnit *>(self);
+    // Unlike getLocalPreprocessingEntities, this includes entities loaded
+    // from a precompiled header, which have negative indices.
+    if (clang::PreprocessingRecord *record = casted->getPreprocessor().getPreprocessingRecord())
+        return bitcast(record->begin());
     return bitcast(casted->getLocalPreprocessingEntities().begin());
 }
 
-struct ZigClangPreprocessingRecord_iterator ZigClangASTUnit_getLocalPreprocessingEntities_end(
+struct ZigClangPreprocessingRecord_iterator ZigClangASTUnit_getPreprocessingEntities_end(
         struct ZigClangASTUnit *self)
 {
-    auto casted = reinterpret_cast<const clang::ASTUnit *>(self);
+    auto casted = reinterpret_cast<clang::ASTUnit *>(self);
+    if (clang::PreprocessingRecord *record = casted->getPreprocessor().getPreprocessingRecord())
+        return bitcast(record->end());
     return bitcast(casted->getLocalPreprocessingEntities().end());
 }
 
@@ -2630,6 +2648,11 @@ bool ZigClangFunctionDecl_hasBody(const struct ZigClangFunctionDecl *self) {
     return casted->hasBody();
 }
 
+bool ZigClangFunctionDecl_hasSkippedBody(const struct ZigClangFunctionDecl *self) {
+    auto casted = reinterpret_cast<const clang::FunctionDecl *>(self);
+    return casted->hasSkippedBody();
+}
+
 enum ZigClangStorageClass ZigClangFunctionDecl_getStorageClass(const struct ZigClangFunctionDecl *self) {
     auto casted = reinterpret_cast<const clang::FunctionDecl *>(self);
     return (ZigClangStorageClass)casted->getStorageClass();
@@ -3039,7 +3062,8 @@ ZigClangAPValueLValueBase ZigClangAPValue_getLValueBase(const ZigClangAPValue *s
 }
 
 ZigClangASTUnit *ZigClangLoadFromCommandLine(const char **args_begin, const char **args_end,
-    struct Stage2ErrorMsg **errors_ptr, size_t *errors_len, const char *resources_path)
+    struct Stage2ErrorMsg **errors_ptr, size_t *errors_len, const char *resources_path,
+    bool skip_function_bodies)
 {
     clang::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diags(clang::CompilerInstance::createDiagnostics(new clang::DiagnosticOptions));
 
@@ -3073,7 +3097,7 @@ ZigClangASTUnit *ZigClangLoadFromCommandLine(const char **args_begin, const char
         false, // cache code completion results
         false, // include brief comments in code completion
         allow_pch_with_compiler_errors,
-        clang::SkipFunctionBodiesScope::None,
+        skip_function_bodies ? clang::SkipFunctionBodiesScope::PreambleAndMainFile : clang::SkipFunctionBodiesScope::None,
         single_file_parse,
         user_files_are_volatile,
         for_serialization,
@@ -15,16 +15,20 @@
 #include "clang/Basic/DiagnosticOptions.h"
 #include "clang/Basic/HeaderInclude.h"
 #include "clang/Basic/Stack.h"
+#include "clang/CodeGen/ObjectFilePCHContainerOperations.h"
 #include "clang/Config/config.h"
 #include "clang/Driver/Compilation.h"
 #include "clang/Driver/DriverDiagnostic.h"
 #include "clang/Driver/Options.h"
 #include "clang/Driver/ToolChain.h"
 #include "clang/Frontend/ChainedDiagnosticConsumer.h"
+#include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/CompilerInvocation.h"
 #include "clang/Frontend/SerializedDiagnosticPrinter.h"
+#include "clang/Frontend/TextDiagnosticBuffer.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Frontend/Utils.h"
+#include "clang/FrontendTool/Utils.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
@@ -48,7 +52,10 @@
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Host.h"
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <system_error>
@@ -601,3 +608,175 @@ extern "C" int ZigClang_main(int, char **);
 int ZigClang_main(int argc, char **argv) {
   return clang_main(argc, argv, {argv[0], nullptr, false});
 }
+
+// Runs the frontend for a single -cc1 job on the calling thread. Unlike
+// cc1_main, this does not touch process-wide state other than the target
+// initialization and ZigCrashRecoveryScope in ZigClang_compileInProcess,
+// writes diagnostics to `OS` instead of stderr, and frees everything it
+// allocates.
+static int ZigExecuteCC1InProcess(ArrayRef<const char *> Argv, const char *Argv0,
+                                  llvm::raw_ostream &OS) {
+  std::unique_ptr<CompilerInstance> Clang(new CompilerInstance());
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
+
+  auto PCHOps = Clang->getPCHContainerOperations();
+  PCHOps->registerWriter(std::make_unique<ObjectFilePCHContainerWriter>());
+  PCHOps->registerReader(std::make_unique<ObjectFilePCHContainerReader>());
+
+  IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts = new DiagnosticOptions();
+  TextDiagnosticBuffer *DiagsBuffer = new TextDiagnosticBuffer;
+  DiagnosticsEngine Diags(DiagID, &*DiagOpts, DiagsBuffer);
+
+  bool Success = CompilerInvocation::CreateFromArgs(Clang->getInvocation(),
+                                                    Argv, Diags, Argv0);
+
+  // The driver passes -disable-free because it expects the process to exit
+  // right after; this process keeps running.
+  Clang->getFrontendOpts().DisableFree = false;
+
+  // A serialized diagnostics consumer is chained onto this client when
+  // --serialize-diagnostics was passed to the driver.
+  Clang->createDiagnostics(
+      new TextDiagnosticPrinter(OS, &Clang->getDiagnosticOpts()),
+      /*ShouldOwnClient=*/true);
+  if (!Clang->hasDiagnostics())
+    return 1;
+
+  DiagsBuffer->FlushDiagnostics(Clang->getDiagnostics());
+  if (!Success) {
+    Clang->getDiagnosticClient().finish();
+    return 1;
+  }
+
+  return !ExecuteCompilerInvocation(Clang.get());
+}
+
+// report_fatal_error exits the process once the handler returns. Inside
+// ZigClang_compileInProcess, unwind to the crash recovery context instead so
+// that only the current compilation fails.
+static void ZigFatalErrorHandler(void *, const char *Message,
+                                 bool GenCrashDiag) {
+  if (llvm::CrashRecoveryContext *CRC =
+          llvm::CrashRecoveryContext::GetCurrent()) {
+    llvm::errs() << "error: clang: " << Message << '\n';
+    CRC->HandleExit(GenCrashDiag ? 70 : 1);
+  }
+  llvm::errs() << "LLVM ERROR: " << Message << '\n';
+}
+
+// The fatal error handler and the crash recovery signal handlers are
+// process-wide, so they are only installed while at least one frontend job is
+// running in ZigClang_compileInProcess, and removed again when the last one
+// finishes. While installed, a fatal error or signal on a thread without a
+// CrashRecoveryContext, such as one running Zig's own LLVM backend, behaves as
+// if they were absent: ZigFatalErrorHandler prints the message and returns so
+// that LLVM exits, and the signal handler restores the previous handlers,
+// including Zig's crash handler, and re-raises the signal.
+namespace {
+class ZigCrashRecoveryScope {
+  static std::mutex Mutex;
+  static unsigned ActiveCount;
+
+public:
+  ZigCrashRecoveryScope() {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (ActiveCount++ == 0) {
+      llvm::install_fatal_error_handler(ZigFatalErrorHandler);
+      llvm::CrashRecoveryContext::Enable();
+    }
+  }
+  ~ZigCrashRecoveryScope() {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (--ActiveCount == 0) {
+      llvm::CrashRecoveryContext::Disable();
+      llvm::remove_fatal_error_handler();
+    }
+  }
+};
+std::mutex ZigCrashRecoveryScope::Mutex;
+unsigned ZigCrashRecoveryScope::ActiveCount = 0;
+} // namespace
+
+// Equivalent to ZigClang_main with the same argv, but runs on the calling
+// thread and may be called from several threads at once. Driver and frontend
+// diagnostics are returned in a malloc'd buffer through `stderr_ptr` and
+// `stderr_len` rather than printed.
+//
+// Returns -1 without compiling anything if the command line does not reduce to
+// exactly one -cc1 job, or if it needs process-wide state (-mllvm); the caller
+// must then run the command in a child process.
+extern "C" int ZigClang_compileInProcess(int argc, const char **argv,
+                                         char **stderr_ptr,
+                                         size_t *stderr_len);
+int ZigClang_compileInProcess(int argc, const char **argv, char **stderr_ptr,
+                              size_t *stderr_len) {
+  static std::once_flag InitFlag;
+  std::call_once(InitFlag, [] {
+    llvm::InitializeAllTargets();
+    llvm::InitializeAllTargetMCs();
+    llvm::InitializeAllAsmPrinters();
+    llvm::InitializeAllAsmParsers();
+  });
+  noteBottomOfStack();
+
+  std::string Output;
+  llvm::raw_string_ostream OS(Output);
+  auto Finish = [&](int Res) {
+    OS.flush();
+    *stderr_len = Output.size();
+    *stderr_ptr = static_cast<char *>(malloc(Output.size() + 1));
+    if (*stderr_ptr == nullptr)
+      *stderr_len = 0;
+    else
+      memcpy(*stderr_ptr, Output.c_str(), Output.size() + 1);
+    return Res;
+  };
+
+  // Skip the "clang" subcommand, as ZigClang_main does.
+  SmallVector<const char *, 256> Args(argv + 1, argv + argc);
+  const char *ProgName = argv[0];
+
+  IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts = new DiagnosticOptions();
+  TextDiagnosticPrinter *DiagClient = new TextDiagnosticPrinter(OS, &*DiagOpts);
+  FixupDiagPrefixExeName(DiagClient, ProgName);
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
+  DiagnosticsEngine Diags(DiagID, &*DiagOpts, DiagClient);
+
+  Driver TheDriver(GetExecutablePath(ProgName, /*CanonicalPrefixes=*/true),
+                   llvm::sys::getDefaultTargetTriple(), Diags);
+  SetInstallDir(Args, TheDriver, /*CanonicalPrefixes=*/true);
+  TheDriver.setTargetAndMode(
+      ToolChain::getTargetAndModeFromProgramName(ProgName));
+
+  std::unique_ptr<Compilation> C(TheDriver.BuildCompilation(Args));
+  if (!C || C->containsError()) {
+    Diags.getClient()->finish();
+    return Finish(1);
+  }
+
+  const JobList &Jobs = C->getJobs();
+  if (Jobs.size() != 1)
+    return Finish(-1);
+  const llvm::opt::ArgStringList &JobArgs = Jobs.begin()->getArguments();
+  if (JobArgs.empty() || StringRef(JobArgs[0]) != "-cc1")
+    return Finish(-1);
+  for (const char *Arg : JobArgs)
+    if (StringRef(Arg) == "-mllvm")
+      return Finish(-1);
+
+  int Res = 1;
+  {
+    ZigCrashRecoveryScope Scope;
+    llvm::CrashRecoveryContext CRC;
+    if (!CRC.RunSafely([&] {
+          Res = ZigExecuteCC1InProcess(ArrayRef(JobArgs).slice(1), ProgName,
+                                       OS);
+        })) {
+      OS << "error: clang frontend command failed due to signal or fatal "
+            "error\n";
+      Res = CRC.RetCode;
+    }
+  }
+  Diags.getClient()->finish();
+  return Finish(Res);
+}
@@ -53,6 +53,7 @@
 #include <llvm/Target/CodeGenCWrappers.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/IPO/ThinLTOBitcodeWriter.h>
 #include <llvm/Transforms/Instrumentation/ThreadSanitizer.h>
 #include <llvm/Transforms/Instrumentation/SanitizerCoverage.h>
 #include <llvm/Transforms/Scalar.h>
@@ -343,8 +344,10 @@ ZIG_EXTERN_C bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machi
 
     // Initialize the PassManager
     if (opt_level == OptimizationLevel::O0) {
-      module_pm = pass_builder.buildO0DefaultPipeline(opt_level, options.lto);
-    } else if (options.lto) {
+      module_pm = pass_builder.buildO0DefaultPipeline(opt_level, options.lto != ZigLLVMLTOMode_None);
+    } else if (options.lto == ZigLLVMLTOMode_Thin) {
+      module_pm = pass_builder.buildThinLTOPreLinkDefaultPipeline(opt_level);
+    } else if (options.lto == ZigLLVMLTOMode_Full) {
       module_pm = pass_builder.buildLTOPreLinkDefaultPipeline(opt_level);
     } else {
       module_pm = pass_builder.buildPerModuleDefaultPipeline(opt_level);
@@ -355,7 +358,13 @@ ZIG_EXTERN_C bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machi
     codegen_pm.add(
       createTargetTransformInfoWrapperPass(target_machine.getTargetIRAnalysis()));
 
-    if (dest_bin && !options.lto) {
+    // ThinLTO bitcode carries the module summary which the linker uses to
+    // decide what to import across modules.
+    if (dest_bin && options.lto == ZigLLVMLTOMode_Thin) {
+        module_pm.addPass(ThinLTOBitcodeWriterPass(*dest_bin, nullptr));
+    }
+
+    if (dest_bin && options.lto == ZigLLVMLTOMode_None) {
         if (target_machine.addPassesToEmitFile(codegen_pm, *dest_bin, nullptr, CodeGenFileType::ObjectFile)) {
             *error_message = strdup("TargetMachine can't emit an object file");
             return true;
@@ -380,7 +389,7 @@ ZIG_EXTERN_C bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machi
         }
     }
 
-    if (dest_bin && options.lto) {
+    if (dest_bin && options.lto == ZigLLVMLTOMode_Full) {
         WriteBitcodeToFile(llvm_module, *dest_bin);
     }
     if (dest_bitcode) {
@@ -523,7 +532,7 @@ bool ZigLLVMWriteImportLibrary(const char *def_path, const ZigLLVM_ArchType arch
 }
 
 bool ZigLLVMWriteArchive(const char *archive_name, const char **file_names, size_t file_name_count,
-        ZigLLVM_OSType os_type)
+        ZigLLVM_OSType os_type, bool thin)
 {
     object::Archive::Kind kind;
     switch (os_type) {
@@ -548,14 +557,27 @@ bool ZigLLVMWriteArchive(const char *archive_name, const char **file_names, size
             kind = object::Archive::K_GNU;
     }
     SmallVector<NewArchiveMember, 4> new_members;
+    // Thin archives refer to members by their path relative to the archive,
+    // like llvm-ar does. These own the strings that MemberName points to.
+    std::vector<std::string> thin_member_names;
+    thin_member_names.reserve(file_name_count);
     for (size_t i = 0; i < file_name_count; i += 1) {
         Expected<NewArchiveMember> new_member = NewArchiveMember::getFile(file_names[i], true);
         Error err = new_member.takeError();
         if (err) return true;
+        if (thin) {
+            Expected<std::string> rel_path = computeArchiveRelativePath(archive_name, file_names[i]);
+            if (Error rel_err = rel_path.takeError()) {
+                consumeError(std::move(rel_err));
+                return true;
+            }
+            thin_member_names.push_back(std::move(*rel_path));
+            new_member->MemberName = thin_member_names.back();
+        }
         new_members.push_back(std::move(*new_member));
     }
     Error err = writeArchive(archive_name, new_members,
-        SymtabWritingMode::NormalSymtab, kind, true, false, nullptr);
+        SymtabWritingMode::NormalSymtab, kind, true, thin, nullptr);
 
     if (err) return true;
     return false;
@@ -52,13 +52,19 @@ struct ZigLLVMCoverageOptions {
     bool CollectControlFlow;
 };
 
+enum ZigLLVMLTOMode {
+    ZigLLVMLTOMode_None,
+    ZigLLVMLTOMode_Full,
+    ZigLLVMLTOMode_Thin
+};
+
 struct ZigLLVMEmitOptions {
     bool is_debug;
     bool is_small;
     bool time_report;
     bool tsan;
     bool sancov;
-    bool lto;
+    enum ZigLLVMLTOMode lto;
     const char *asm_filename;
     const char *bin_filename;
     const char *llvm_ir_filename;
@@ -399,7 +405,7 @@ ZIG_EXTERN_C bool ZigLLDLinkELF(int argc, const char **argv, bool can_exit_early
 ZIG_EXTERN_C bool ZigLLDLinkWasm(int argc, const char **argv, bool can_exit_early, bool disable_output);
 
 ZIG_EXTERN_C bool ZigLLVMWriteArchive(const char *archive_name, const char **file_names, size_t file_name_count,
-        enum ZigLLVM_OSType os_type);
+        enum ZigLLVM_OSType os_type, bool thin);
 
 ZIG_EXTERN_C bool ZigLLVMWriteImportLibrary(const char *def_path, const enum ZigLLVM_ArchType arch,
                                const char *output_lib_path, bool kill_at);
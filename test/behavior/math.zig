@@ -306,6 +306,41 @@ test "comptime_int addition" {
     }
 }
 
+test "comptime integer addition and subtraction around 64 bits" {
+    comptime {
+        var a = maxInt(u64);
+        a += 1;
+        try expect(a == 1 << 64);
+        a -= maxInt(u64) + 2;
+        try expect(a == -1);
+
+        var b = minInt(i64);
+        b -= maxInt(u64);
+        try expect(b == -(3 << 63) + 1);
+        try expect(b < minInt(i64));
+        try expect(maxInt(u64) > minInt(i64));
+
+        var c: u64 = maxInt(u64) - 1;
+        c += 1;
+        try expect(c == maxInt(u64));
+        try expect(@addWithOverflow(c, 1)[0] == 0);
+        try expect(@addWithOverflow(c, 1)[1] == 1);
+
+        var d: i64 = minInt(i64) + 1;
+        d -= 1;
+        try expect(d == minInt(i64));
+        try expect(@subWithOverflow(d, 1)[0] == maxInt(i64));
+        try expect(@subWithOverflow(d, 1)[1] == 1);
+
+        try expect(@addWithOverflow(@as(u7, 100), 27)[1] == 0);
+        try expect(@addWithOverflow(@as(u7, 100), 28)[1] == 1);
+        try expect(@subWithOverflow(@as(u7, 0), 1)[0] == maxInt(u7));
+        try expect(@addWithOverflow(@as(i1, -1), -1)[1] == 1);
+        try expect(@subWithOverflow(@as(u128, 0), 1)[0] == maxInt(u128));
+        try expect(@subWithOverflow(@as(i65, minInt(i64)), maxInt(u64))[1] == 1);
+    }
+}
+
 test "comptime_int multiplication" {
     comptime {
         try expect(
@@ -907,6 +907,33 @@ test "vector reduce operation" {
     try comptime S.doTheTest();
 }
 
+test "vector reduce integer add and bitwise" {
+    if (builtin.zig_backend == .stage2_wasm) return error.SkipZigTest; // TODO
+    if (builtin.zig_backend == .stage2_aarch64) return error.SkipZigTest; // TODO
+    if (builtin.zig_backend == .stage2_arm) return error.SkipZigTest; // TODO
+    if (builtin.zig_backend == .stage2_sparc64) return error.SkipZigTest; // TODO
+    if (builtin.zig_backend == .stage2_spirv64) return error.SkipZigTest;
+    if (builtin.zig_backend == .stage2_c and comptime builtin.cpu.arch.isArmOrThumb()) return error.SkipZigTest;
+    if (builtin.zig_backend == .stage2_riscv64) return error.SkipZigTest;
+
+    var a: @Vector(4, u32) = .{ 1, 20, 300, 0xffff_f000 };
+    var b: @Vector(16, u8) = .{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 250 };
+    var c: @Vector(8, i16) = .{ -1, -2, -3, -4, 5, 6, 7, 8 };
+    var d: @Vector(2, i64) = .{ -0x1234_5678_9abc, 0x0fff_0000_0000_0001 };
+    _ = .{ &a, &b, &c, &d };
+
+    try expect(@reduce(.Add, a) == 0xffff_f000 + 321);
+    try expect(@reduce(.And, a) == 0);
+    try expect(@reduce(.Or, a) == 0xffff_f13d);
+    try expect(@reduce(.Xor, a) == 1 ^ 20 ^ 300 ^ 0xffff_f000);
+    try expect(@reduce(.Add, b) == 114); // wraps
+    try expect(@reduce(.Xor, b) == 1 ^ 2 ^ 3 ^ 4 ^ 5 ^ 6 ^ 7 ^ 8 ^ 9 ^ 10 ^ 11 ^ 12 ^ 13 ^ 14 ^ 15 ^ 250);
+    try expect(@reduce(.Add, c) == 16);
+    try expect(@reduce(.Or, c) == -1);
+    try expect(@reduce(.Add, d) == -0x1234_5678_9abc + 0x0fff_0000_0000_0001);
+    try expect(@reduce(.And, d) == -0x1234_5678_9abc & 0x0fff_0000_0000_0001);
+}
+
 test "vector @reduce comptime" {
     if (builtin.zig_backend == .stage2_wasm) return error.SkipZigTest; // TODO
     if (builtin.zig_backend == .stage2_aarch64) return error.SkipZigTest; // TODO
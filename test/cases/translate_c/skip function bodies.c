@@ -0,0 +1,27 @@
+struct point {
+    int x;
+    int y;
+};
+
+int sub(int a, int b);
+
+static inline int add(int a, int b) {
+    return a + b;
+}
+
+#define ANSWER 42
+
+// translate-c
+// target=x86_64-linux
+// skip_function_bodies=true
+//
+// pub const struct_point = extern struct {
+//     x: c_int = @import("std").mem.zeroes(c_int),
+//     y: c_int = @import("std").mem.zeroes(c_int),
+// };
+//
+// pub extern fn sub(a: c_int, b: c_int) c_int;
+//
+// pub const add = @compileError("function body not translated due to -fcimport-skip-function-bodies");
+//
+// pub const ANSWER = @as(c_int, 42);
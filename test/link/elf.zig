@@ -55,6 +55,7 @@ pub fn testAll(b: *Build, build_opts: BuildOptions) *Step {
 
         // Exercise linker in ar mode
         elf_step.dependOn(testEmitStaticLib(b, .{ .target = musl_target }));
+        elf_step.dependOn(testEmitStaticLibLld(b, .{ .target = musl_target, .use_lld = true }));
 
         // Exercise linker with LLVM backend
         // musl tests
@@ -1017,6 +1018,56 @@ fn testEmitStaticLibZig(b: *Build, opts: Options) *Step {
     return test_step;
 }
 
+/// With LLD, static libraries are written by the compiler's own archive writer.
+fn testEmitStaticLibLld(b: *Build, opts: Options) *Step {
+    const test_step = addTestStep(b, "emit-static-lib-lld", opts);
+
+    const obj1 = addObject(b, opts, .{
+        .name = "obj1",
+        .c_source_bytes =
+        \int foo() { return 1; }
+        \int bar = 2;
+        ,
+    });
+    const obj2 = addObject(b, opts, .{
+        .name = "a_very_long_file_name_so_that_it_ends_up_in_strtab",
+        .c_source_bytes =
+        \char odd[3] = "ab";
+        \int baz() { return 3; }
+        ,
+    });
+
+    for ([_]bool{ false, true }) |thin| {
+        const lib = addStaticLibrary(b, opts, .{ .name = if (thin) "thin" else "lib" });
+        lib.addObject(obj1);
+        lib.addObject(obj2);
+        lib.thin_archive = thin;
+
+        const exe = addExecutable(b, opts, .{
+            .name = if (thin) "main-thin" else "main",
+            .c_source_bytes =
+            \#include <stdio.h>
+            \int foo();
+            \int baz();
+            \extern int bar;
+            \extern char odd[3];
+            \int main() {
+            \  printf("%d %d %d %s\n", foo(), bar, baz(), odd);
+            \  return 0;
+            \}
+            ,
+        });
+        exe.linkLibrary(lib);
+        exe.linkLibC();
+
+        const run = addRunArtifact(exe);
+        run.expectStdOutEqual("1 2 3 ab\n");
+        test_step.dependOn(&run.step);
+    }
+
+    return test_step;
+}
+
 fn testEmptyObject(b: *Build, opts: Options) *Step {
     const test_step = addTestStep(b, "empty-object", opts);
 
@@ -158,6 +158,7 @@ pub const Translate = struct {
     target: std.Build.ResolvedTarget,
     link_libc: bool,
     c_frontend: CFrontend,
+    skip_function_bodies: bool,
     kind: union(enum) {
         /// Translate the input, run it and check that it
         /// outputs the expected text.
@@ -424,6 +425,7 @@ fn addFromDirInner(
         const c_frontends = try manifest.getConfigForKeyAlloc(ctx.arena, "c_frontend", CFrontend);
         const is_test = try manifest.getConfigForKeyAssertSingle("is_test", bool);
         const link_libc = try manifest.getConfigForKeyAssertSingle("link_libc", bool);
+        const skip_function_bodies = try manifest.getConfigForKeyAssertSingle("skip_function_bodies", bool);
         const output_mode = try manifest.getConfigForKeyAssertSingle("output_mode", std.builtin.OutputMode);
 
         if (manifest.type == .translate_c) {
@@ -435,6 +437,7 @@ fn addFromDirInner(
                         .c_frontend = c_frontend,
                         .target = b.resolveTargetQuery(target_query),
                         .link_libc = link_libc,
+                        .skip_function_bodies = skip_function_bodies,
                         .input = src,
                         .kind = .{ .translate = output },
                     });
@@ -451,6 +454,7 @@ fn addFromDirInner(
                         .c_frontend = c_frontend,
                         .target = b.resolveTargetQuery(target_query),
                         .link_libc = link_libc,
+                        .skip_function_bodies = skip_function_bodies,
                         .input = src,
                         .kind = .{ .run = output },
                     });
@@ -576,6 +580,7 @@ pub fn lowerToTranslateCSteps(
                 .target = case.target,
                 .link_libc = case.link_libc,
                 .use_clang = case.c_frontend == .clang,
+                .skip_function_bodies = case.skip_function_bodies,
             });
             translate_c.step.name = b.fmt("{s} translate-c", .{annotated_case_name});
 
@@ -605,6 +610,7 @@ pub fn lowerToTranslateCSteps(
                 .target = case.target,
                 .link_libc = case.link_libc,
                 .use_clang = case.c_frontend == .clang,
+                .skip_function_bodies = case.skip_function_bodies,
             });
             translate_c.step.name = b.fmt("{s} translate-c", .{annotated_case_name});
 
@@ -946,6 +952,8 @@ const TestManifestConfigDefaults = struct {
             return "false";
         } else if (std.mem.eql(u8, key, "link_libc")) {
             return "false";
+        } else if (std.mem.eql(u8, key, "skip_function_bodies")) {
+            return "false";
         } else if (std.mem.eql(u8, key, "c_frontend")) {
             return "clang";
         } else unreachable;
@@ -980,6 +988,7 @@ const TestManifest = struct {
         .{ "target", {} },
         .{ "c_frontend", {} },
         .{ "link_libc", {} },
+        .{ "skip_function_bodies", {} },
         .{ "backend", {} },
     });
 
@@ -0,0 +1,81 @@
+const std = @import("std");
+
+pub fn build(b: *std.Build) void {
+    const test_step = b.step("test", "Test it");
+    b.default_step = test_step;
+
+    // A private cache directory, so that the precompiled header can be
+    // corrupted without affecting other tests.
+    const cache_path = b.makeTempPath();
+
+    // The first `@cImport` builds the precompiled header and translates its
+    // declarations and macros.
+    const run_main = addZigTest(b, cache_path, "main.zig");
+    run_main.setName("@cImport with a precompiled header");
+
+    const corrupt = CorruptPch.init(b, cache_path);
+    corrupt.step.dependOn(&run_main.step);
+
+    // The second `@cImport` has the same preamble, so it reuses the corrupted
+    // precompiled header, fails, and translates again without it.
+    const run_fallback = addZigTest(b, cache_path, "fallback.zig");
+    run_fallback.setName("@cImport with a corrupted precompiled header");
+    run_fallback.step.dependOn(&corrupt.step);
+
+    const cleanup = b.addRemoveDirTree(.{ .cwd_relative = cache_path });
+    cleanup.step.dependOn(&run_fallback.step);
+
+    test_step.dependOn(&cleanup.step);
+}
+
+fn addZigTest(b: *std.Build, cache_path: []const u8, root_src: []const u8) *std.Build.Step.Run {
+    const run = b.addSystemCommand(&.{ b.graph.zig_exe, "test", "--cache-dir", cache_path });
+    run.addPrefixedDirectoryArg("-I", b.path("."));
+    run.addFileArg(b.path(root_src));
+    run.has_side_effects = true;
+    run.expectExitCode(0);
+    return run;
+}
+
+/// Overwrites every precompiled `@cImport` preamble in the cache directory.
+/// Fails if there is none, which means that the preamble was not precompiled.
+const CorruptPch = struct {
+    step: std.Build.Step,
+    cache_path: []const u8,
+
+    pub fn init(owner: *std.Build, cache_path: []const u8) *CorruptPch {
+        const corrupt = owner.allocator.create(CorruptPch) catch @panic("OOM");
+        corrupt.* = .{
+            .step = std.Build.Step.init(.{
+                .id = .custom,
+                .name = "corrupt precompiled headers",
+                .owner = owner,
+                .makeFn = make,
+            }),
+            .cache_path = cache_path,
+        };
+        return corrupt;
+    }
+
+    fn make(step: *std.Build.Step, _: std.Build.Step.MakeOptions) !void {
+        const corrupt: *CorruptPch = @fieldParentPtr("step", step);
+        const o_path = try std.fs.path.join(step.owner.allocator, &.{ corrupt.cache_path, "o" });
+        var o_dir = try std.fs.cwd().openDir(o_path, .{ .iterate = true });
+        defer o_dir.close();
+
+        var count: usize = 0;
+        var it = o_dir.iterate();
+        while (try it.next()) |entry| {
+            if (entry.kind != .directory) continue;
+            var dir = try o_dir.openDir(entry.name, .{});
+            defer dir.close();
+            dir.access("cimport.pch", .{}) catch |err| switch (err) {
+                error.FileNotFound => continue,
+                else => |e| return e,
+            };
+            try dir.writeFile(.{ .sub_path = "cimport.pch", .data = "not a precompiled header" });
+            count += 1;
+        }
+        if (count == 0) return step.fail("no precompiled header in '{s}'", .{o_path});
+    }
+};
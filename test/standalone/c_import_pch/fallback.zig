@@ -0,0 +1,14 @@
+const std = @import("std");
+
+// Same preamble as main.zig, so this reuses its precompiled header.
+const c = @cImport({
+    @cInclude("pch.h");
+    @cDefine("FALLBACK_ANSWER", "PCH_ANSWER");
+});
+
+test "a broken precompiled header falls back to parsing the headers" {
+    const point: c.struct_pch_point = .{ .x = 1, .y = 2 };
+    try std.testing.expectEqual(3, point.x + point.y);
+    try std.testing.expectEqual(42, c.PCH_DOUBLE(21));
+    try std.testing.expectEqual(42, c.FALLBACK_ANSWER);
+}
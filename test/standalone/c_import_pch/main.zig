@@ -0,0 +1,19 @@
+const std = @import("std");
+
+// The `#include` lines are precompiled, the `#define` after them is not.
+const c = @cImport({
+    @cInclude("pch.h");
+    @cDefine("MAIN_ANSWER", "PCH_ANSWER");
+});
+
+test "declarations from the precompiled header are translated" {
+    const point: c.struct_pch_point = .{ .x = 1, .y = 2 };
+    try std.testing.expectEqual(3, point.x + point.y);
+    try std.testing.expect(@TypeOf(c.pch_add) == fn (c_int, c_int) callconv(.C) c_int);
+}
+
+test "macros from the precompiled header are translated" {
+    try std.testing.expectEqual(42, c.PCH_ANSWER);
+    try std.testing.expectEqual(42, c.PCH_DOUBLE(21));
+    try std.testing.expectEqual(42, c.MAIN_ANSWER);
+}
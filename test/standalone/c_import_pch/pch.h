@@ -0,0 +1,9 @@
+struct pch_point {
+    int x;
+    int y;
+};
+
+int pch_add(int a, int b);
+
+#define PCH_ANSWER 42
+#define PCH_DOUBLE(x) ((x) * 2)
@@ -0,0 +1,118 @@
+const std = @import("std");
+
+pub fn build(b: *std.Build) void {
+    const test_step = b.step("test", "Test it");
+    b.default_step = test_step;
+
+    // The sources are written to a private directory, rather than a
+    // `WriteFile` step, so that they keep their paths when one of them is
+    // edited, and the cache directory is private so that only this test's
+    // entries are involved.
+    const tmp_path = b.makeTempPath();
+    const src_path = b.pathJoin(&.{ tmp_path, "src" });
+    const cache_path = b.pathJoin(&.{ tmp_path, "cache" });
+
+    const write_sources = WriteSources.init(b, src_path, &.{
+        .{
+            .basename = "base.cppm",
+            .data =
+            \\export module base;
+            \\export int base_value() { return 1; }
+            \\
+            ,
+        },
+        .{
+            .basename = "derived.cppm",
+            .data =
+            \\export module derived;
+            \\import base;
+            \\export int derived_value() { return base_value() + 10; }
+            \\
+            ,
+        },
+        .{
+            .basename = "main.cpp",
+            .data =
+            \\import derived;
+            \\int main() { return derived_value(); }
+            \\
+            ,
+        },
+    });
+
+    // `main.cpp` only imports `derived`, which in turn imports `base`.
+    const run_first = addZigRun(b, src_path, cache_path);
+    run_first.setName("run with the original interface");
+    run_first.expectExitCode(11);
+    run_first.step.dependOn(&write_sources.step);
+
+    const edit_base = WriteSources.init(b, src_path, &.{
+        .{
+            .basename = "base.cppm",
+            .data =
+            \\export module base;
+            \\export int base_value() { return 1 + 1; }
+            \\
+            ,
+        },
+    });
+    edit_base.step.dependOn(&run_first.step);
+
+    // The edit must reach `main.cpp` through `derived`.
+    const run_second = addZigRun(b, src_path, cache_path);
+    run_second.setName("run with the edited interface");
+    run_second.expectExitCode(12);
+    run_second.step.dependOn(&edit_base.step);
+
+    const cleanup = b.addRemoveDirTree(.{ .cwd_relative = tmp_path });
+    cleanup.step.dependOn(&run_second.step);
+
+    test_step.dependOn(&cleanup.step);
+}
+
+fn addZigRun(b: *std.Build, src_path: []const u8, cache_path: []const u8) *std.Build.Step.Run {
+    const run = b.addSystemCommand(&.{ b.graph.zig_exe, "run", "--cache-dir", cache_path, "-cflags", "-std=c++20", "--" });
+    for ([_][]const u8{ "base.cppm", "derived.cppm", "main.cpp" }) |basename| {
+        run.addArg(b.pathJoin(&.{ src_path, basename }));
+    }
+    run.addArg("-lc++");
+    run.has_side_effects = true;
+    return run;
+}
+
+/// Writes files into a directory outside of the cache, replacing any
+/// previous contents.
+const WriteSources = struct {
+    step: std.Build.Step,
+    dir_path: []const u8,
+    files: []const File,
+
+    const File = struct {
+        basename: []const u8,
+        data: []const u8,
+    };
+
+    pub fn init(owner: *std.Build, dir_path: []const u8, files: []const File) *WriteSources {
+        const write_sources = owner.allocator.create(WriteSources) catch @panic("OOM");
+        write_sources.* = .{
+            .step = std.Build.Step.init(.{
+                .id = .custom,
+                .name = "write sources",
+                .owner = owner,
+                .makeFn = make,
+            }),
+            .dir_path = dir_path,
+            .files = owner.allocator.dupe(File, files) catch @panic("OOM"),
+        };
+        return write_sources;
+    }
+
+    fn make(step: *std.Build.Step, _: std.Build.Step.MakeOptions) !void {
+        const write_sources: *WriteSources = @fieldParentPtr("step", step);
+        var dir = try std.fs.cwd().makeOpenPath(write_sources.dir_path, .{});
+        defer dir.close();
+        for (write_sources.files) |file| {
+            try dir.writeFile(.{ .sub_path = file.basename, .data = file.data });
+        }
+    }
+};
@@ -27,6 +27,7 @@ const TestTarget = struct {
     use_lld: ?bool = null,
     pic: ?bool = null,
     strip: ?bool = null,
+    air_optimize: ?bool = null,
 };
 
 const test_targets = blk: {
@@ -115,6 +116,16 @@ const test_targets = blk: {
             .use_lld = false,
             .strip = true,
         },
+        .{
+            .target = .{
+                .cpu_arch = .x86_64,
+                .os_tag = .linux,
+                .abi = .none,
+            },
+            .use_llvm = false,
+            .use_lld = false,
+            .air_optimize = true,
+        },
         // Doesn't support new liveness
         //.{
         //    .target = .{
@@ -909,6 +920,45 @@ pub fn addCliTests(b: *std.Build) *Step {
         step.dependOn(&cleanup.step);
     }
 
+    {
+        // Test `-fclang-in-process`, which compiles C files on the calling
+        // thread instead of spawning clang.
+        const tmp_path = b.makeTempPath();
+        const write_files = b.addWriteFiles();
+        const good_c = write_files.add("good.c",
+            \\int square(int num) {
+            \\    return num * num;
+            \\}
+            \\
+        );
+        const bad_c = write_files.add("bad.c",
+            \\int square(int num) {
+            \\    return num * undeclared_name;
+            \\}
+            \\
+        );
+
+        const run_good = b.addSystemCommand(&.{ b.graph.zig_exe, "build-obj", "--cache-dir", tmp_path, "--name", "good", "-fclang-in-process" });
+        run_good.setName("compile C in process");
+        run_good.addFileArg(good_c);
+        _ = run_good.addPrefixedOutputFileArg("-femit-bin=", "good.o");
+        run_good.expectExitCode(0);
+        run_good.expectStdErrEqual("");
+
+        const run_bad = b.addSystemCommand(&.{ b.graph.zig_exe, "build-obj", "--cache-dir", tmp_path, "--name", "bad", "-fclang-in-process" });
+        run_bad.setName("report C diagnostics in process");
+        run_bad.addFileArg(bad_c);
+        _ = run_bad.addPrefixedOutputFileArg("-femit-bin=", "bad.o");
+        run_bad.expectExitCode(1);
+        run_bad.addCheck(.{ .expect_stderr_match = "use of undeclared identifier 'undeclared_name'" });
+
+        const cleanup = b.addRemoveDirTree(.{ .cwd_relative = tmp_path });
+        cleanup.step.dependOn(&run_good.step);
+        cleanup.step.dependOn(&run_bad.step);
+
+        step.dependOn(&cleanup.step);
+    }
+
     {
         // TODO this should move to become a CLI test rather than standalone
         //    cases.addBuildFile("test/standalone/options/build.zig", .{
@@ -1004,6 +1054,10 @@ pub fn addModuleTests(b: *std.Build, options: ModuleTestOptions) *Step {
         if (options.skip_single_threaded and test_target.single_threaded == true)
             continue;
 
+        // Air.Optimize is only exercised by the behavior tests.
+        if (test_target.air_optimize == true and !mem.eql(u8, options.name, "behavior"))
+            continue;
+
         // TODO get compiler-rt tests passing for self-hosted backends.
         if ((target.cpu.arch != .x86_64 or target.ofmt != .elf) and
             test_target.use_llvm == false and mem.eql(u8, options.name, "compiler-rt"))
@@ -1069,6 +1123,7 @@ pub fn addModuleTests(b: *std.Build, options: ModuleTestOptions) *Step {
             .strip = test_target.strip,
         });
         if (options.no_builtin) these_tests.no_builtin = true;
+        these_tests.air_optimize = test_target.air_optimize;
         const single_threaded_suffix = if (test_target.single_threaded == true) "-single" else "";
         const backend_suffix = if (test_target.use_llvm == true)
             "-llvm"
@@ -1080,10 +1135,11 @@ pub fn addModuleTests(b: *std.Build, options: ModuleTestOptions) *Step {
             "";
         const use_lld = if (test_target.use_lld == false) "-no-lld" else "";
         const use_pic = if (test_target.pic == true) "-pic" else "";
+        const air_optimize = if (test_target.air_optimize == true) "-air-opt" else "";
 
         for (options.include_paths) |include_path| these_tests.addIncludePath(b.path(include_path));
 
-        const qualified_name = b.fmt("{s}-{s}-{s}-{s}{s}{s}{s}{s}{s}", .{
+        const qualified_name = b.fmt("{s}-{s}-{s}-{s}{s}{s}{s}{s}{s}{s}", .{
             options.name,
             triple_txt,
             model_txt,
@@ -1093,6 +1149,7 @@ pub fn addModuleTests(b: *std.Build, options: ModuleTestOptions) *Step {
             backend_suffix,
             use_lld,
             use_pic,
+            air_optimize,
         });
 
         if (target.ofmt == std.Target.ObjectFormat.c) {